@@ -11,7 +11,13 @@
 */
 
 #include <iostream>
-#include <iomanip>  // For std::setw
+#include <cmath>    // For std::fabs
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <algorithm>
 
 #include <dds/pub/ddspub.hpp>
 #include <dds/sub/ddssub.hpp>
@@ -28,48 +34,383 @@
 //    https://community.rti.com/static/documentation/connext-dds/7.3.0/doc/api/connext_dds/api_cpp2/group__DDSCpp2Conventions.html
 
 #include "application.hpp"  // for command line parsing and ctrl-c
+#include "latency.hpp"      // for now_ns()
+#include "transport.hpp"    // for shared memory and reused samples
+#include "realtime.hpp"     // for scheduling, affinity and memory locking
+#include "metrics.hpp"      // for counters and histograms
+#include "periodic.hpp"     // for the fixed-step actuator model
+#include "trace.hpp"        // for recording the steering traffic
+#include "failover.hpp"     // for the failover reaction times
+#include "fleet.hpp"        // for the vehicle partitions
+#include "startup.hpp"      // for the startup profile
+#include "watchdog.hpp"     // for the command timeout
+#include "eventlog.hpp"     // for logging off the control loops
+#include "filter.hpp"       // for the delta filter of the displays
 #include "Steering_t.hpp"
 using namespace rti;
 
-#define OUTPUT_WIDTH 35
+// The startup profile of this app, or of this component of the launcher;
+// the first call starts it (at the top of main())
+startup::Profiler& column_profiler()
+{
+    static startup::Profiler instance("SteeringColumn");
+    return instance;
+}
+
+// Metrics collected by the actuator
+struct ColumnMetrics : metrics::ComponentMetrics {
+    ColumnMetrics()
+        : metrics::ComponentMetrics("SteeringColumn"),
+        commands_skipped(
+            "steering_commands_skipped_total",
+            "Commands skipped because a newer one arrived in the same batch",
+            "SteeringColumn"),
+        samples_suppressed(
+            "steering_samples_suppressed_total",
+            "Status updates suppressed by the deadband",
+            "SteeringColumn"),
+        commands_stale(
+            "steering_commands_stale_total",
+            "Commands dropped because they were older than the maximum age",
+            "SteeringColumn"),
+        dispatch_latency(
+            "steering_dispatch_latency_seconds",
+            "Time from the reception of a command to its processing",
+            "SteeringColumn"),
+        command_age(
+            "steering_command_age_seconds",
+            "Time from the source timestamp of a command to its reception",
+            "SteeringColumn") {}
+
+    metrics::Counter commands_skipped;
+    metrics::Counter samples_suppressed;
+    metrics::Counter commands_stale;
+    // The scheduling delay of the control loop
+    metrics::Histogram dispatch_latency;
+    // The delay of the commands in the writer and in transport
+    metrics::Histogram command_age;
+};
+
+// Publishes the actual steering position. With a deadband, updates that stay
+// within the deadband of the last position published are suppressed, and the
+// latest position (published or not) is written as a keep-alive when nothing
+// else was written for a while.
+class StatusPublisher {
+public:
+    StatusPublisher(
+        dds::pub::DataWriter<actuation::SteeringActual> writer,
+        float deadband,
+        unsigned int keepalive_ms,
+        ColumnMetrics& metrics,
+        trace::Recorder& recorder,
+        const netsim::LinkProfile& link = netsim::LinkProfile())
+        : sample_writer_(writer, link),
+        deadband_(deadband),
+        keepalive_ns_(static_cast<int64_t>(keepalive_ms) * 1000000),
+        published_(false),
+        last_position_(0.0f),
+        latest_position_(0.0f),
+        last_write_ns_(0),
+        metrics_(metrics),
+        recorder_(recorder) {}
+
+    // Publish unconditionally (e.g. the safe state)
+    void write(float position)
+    {
+        sample_writer_.write(position);
+        published_ = true;
+        last_position_ = position;
+        latest_position_ = position;
+        last_write_ns_ = latency::now_ns();
+        metrics_.samples_written.increment();
+        recorder_.record(trace::status_written, position, latency::system_now_ns());
+    }
+
+    // Publish unless the position is within the deadband
+    void update(float position)
+    {
+        if (published_ && std::fabs(position - last_position_) < deadband_) {
+            latest_position_ = position;
+            metrics_.samples_suppressed.increment();
+            return;
+        }
+        write(position);
+    }
+
+    // Publish the latest position if the keep-alive period has elapsed, so
+    // that the status does not stay off by up to the deadband
+    void keep_alive()
+    {
+        if (published_ && keepalive_enabled()
+                && latency::now_ns() - last_write_ns_ >= keepalive_ns_) {
+            write(latest_position_);
+        }
+    }
+
+    // How long the actuator may wait before the next keep-alive is due
+    dds::core::Duration keepalive_period() const
+    {
+        return dds::core::Duration::from_millisecs(keepalive_ns_ / 1000000);
+    }
+
+    bool keepalive_enabled() const { return deadband_ > 0.0f && keepalive_ns_ > 0; }
+
+    // Prints the statistics of the simulated link, if any
+    void print_statistics(std::ostream& out) const { sample_writer_.print_statistics(out); }
+
+private:
+    transport::SampleWriter<actuation::SteeringActual> sample_writer_;
+    float deadband_;
+    int64_t keepalive_ns_;
+    bool published_;
+    float last_position_;    // published
+    float latest_position_;  // published or suppressed
+    int64_t last_write_ns_;
+    ColumnMetrics& metrics_;
+    trace::Recorder& recorder_;
+};
+
+// Fixed-step model of the steering column dynamics: the position moves
+// toward the commanded target no faster than the slew rate, and the
+// velocity changes no faster than the acceleration limit, decelerating in
+// time to stop on the target. The target may be set from any thread; the
+// model is stepped from a single thread.
+class ActuatorModel {
+public:
+    ActuatorModel(float slew_rate, float max_acceleration)
+        : target_(0.0f),
+        slew_rate_(slew_rate),
+        max_acceleration_(max_acceleration),
+        position_(0.0f),
+        velocity_(0.0f) {}
+
+    void target(float position)
+    {
+        target_.store(position, std::memory_order_relaxed);
+    }
+
+    // Advances the model by dt seconds and returns the new position
+    float step(float dt)
+    {
+        float error = target_.load(std::memory_order_relaxed) - position_;
+
+        // Fastest velocity from which the column can still stop on target
+        float desired_velocity = std::sqrt(2.0f * max_acceleration_ * std::fabs(error));
+        desired_velocity = std::min(desired_velocity, slew_rate_);
+        if (error < 0.0f) {
+            desired_velocity = -desired_velocity;
+        }
+
+        float max_change = max_acceleration_ * dt;
+        float change = std::max(-max_change, std::min(max_change, desired_velocity - velocity_));
+        velocity_ += change;
+
+        // Do not overshoot the target within a step. Moving away from the
+        // target (e.g. after it was reversed), the column decelerates
+        // through zero at the maximum acceleration instead.
+        float delta = velocity_ * dt;
+        if (delta * error > 0.0f && std::fabs(delta) >= std::fabs(error)) {
+            position_ += error;
+            velocity_ = 0.0f;
+        } else {
+            position_ += delta;
+        }
+        return position_;
+    }
+
+private:
+    std::atomic<float> target_;
+    float slew_rate_;
+    float max_acceleration_;
+    float position_;
+    float velocity_;
+};
+
+// Carries out the steering commands: either echoes them directly as the
+// actual position, or, with an actuator model, sets the target that the
+// model moves toward (and publishes from its own thread). The watchdog may
+// steer to neutral from its own thread, so the commands are serialized.
+// The safe state is reached when the neutral position is published: at
+// once without the model, or once the model got there.
+class SteeringActuator {
+public:
+    SteeringActuator(StatusPublisher& publisher, ActuatorModel *model)
+        : publisher_(publisher),
+        model_(model),
+        steering_to_neutral_(false),
+        neutral_ns_(0) {}
+
+    // A command from the (primary) controller
+    void command(float position)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (model_ != NULL) {
+            steering_to_neutral_.store(false);
+            model_->target(position);
+        } else {
+            publisher_.update(position);
+        }
+    }
+
+    // No active controllers: go to the safe state
+    void steer_to_neutral()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        steer_to_neutral_locked();
+    }
+
+    // Go to the safe state only if 'still_needed()' holds once no command
+    // is being applied; returns whether it did
+    template <typename Predicate>
+    bool steer_to_neutral_if(Predicate still_needed)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!still_needed()) {
+            return false;
+        }
+        steer_to_neutral_locked();
+        return true;
+    }
+
+    // Republish the position if nothing was written for a while; the model
+    // does this on its own
+    void keep_alive()
+    {
+        if (model_ == NULL) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            publisher_.keep_alive();
+        }
+    }
 
-void process_data(dds::sub::DataReader<actuation::SteeringDesired> reader, dds::pub::DataWriter<actuation::SteeringActual> writer)
+    // Called from the model thread with the position the model reached.
+    // Neutral is published unconditionally when it is the safe state.
+    void publish_model_position(float position)
+    {
+        if (position == 0.0f && steering_to_neutral_.exchange(false)) {
+            publisher_.write(position);
+            neutral_ns_.store(latency::system_now_ns());
+        } else {
+            publisher_.update(position);
+        }
+        publisher_.keep_alive();
+    }
+
+    // When the safe state was reached, on latency::system_now_ns(), if it
+    // was since the last call; 0 otherwise
+    int64_t take_safe_state_ns() { return neutral_ns_.exchange(0); }
+
+private:
+    void steer_to_neutral_locked()
+    {
+        if (model_ != NULL) {
+            steering_to_neutral_.store(true);
+            model_->target(0.0f);
+        } else {
+            publisher_.write(0);
+            neutral_ns_.store(latency::system_now_ns());
+        }
+    }
+
+    StatusPublisher& publisher_;
+    ActuatorModel *model_;
+    std::mutex mutex_;
+    std::atomic<bool> steering_to_neutral_;  // until the model reaches neutral
+    std::atomic<int64_t> neutral_ns_;        // on system_now_ns(), 0 if taken
+};
+
+// Applies the commands received, unless they are older than 'max_age_ns'
+// (if not 0) from their source timestamp to their reception
+void process_data(
+    dds::sub::DataReader<actuation::SteeringDesired> reader,
+    SteeringActuator& actuator,
+    bool latest_only,
+    int64_t max_age_ns,
+    ColumnMetrics& metrics,
+    trace::Recorder& recorder,
+    failover::ReactionTimer& reaction,
+    watchdog::Watchdog& watchdog,
+    size_t watchdog_channel)
 {
     // Take all samples
     dds::sub::LoanedSamples<actuation::SteeringDesired> samples = reader.take();
-    for (auto sample : samples) {
+    int64_t now_ns = latency::system_now_ns();
+    const actuation::SteeringDesired *latest = NULL;
+    dds::core::InstanceHandle latest_writer;
+    int64_t latest_reception_ns = 0;
+    for (const auto& sample : samples) {
         if (sample.info().valid()) {
+            metrics.samples_taken.increment();
             if (sample.info().state().sample_state() == dds::sub::status::SampleState::not_read()) {
-                writer.write(actuation::SteeringActual(sample.data().position()));
+                int64_t reception_ns = latency::to_ns(sample.info().extensions().reception_timestamp());
+                metrics.dispatch_latency.record(now_ns - reception_ns);
+                recorder.record(trace::command_received, sample.data().position(), reception_ns);
+
+                // A command delayed in the writer or in transport must not
+                // move the wheel, nor keep the watchdog from firing
+                int64_t age_ns = reception_ns - latency::to_ns(sample.info().source_timestamp());
+                metrics.command_age.record(std::max<int64_t>(age_ns, 0));
+                if (max_age_ns > 0 && age_ns > max_age_ns) {
+                    metrics.commands_stale.increment();
+                    eventlog::record(
+                        eventlog::command_stale,
+                        sample.info().publication_handle(),
+                        0,
+                        0,
+                        age_ns / 1e6);
+                    continue;
+                }
+                watchdog.arm(watchdog_channel);
+
+                if (latest_only) {
+                    // Only the newest command in the batch is applied
+                    if (latest != NULL) {
+                        metrics.commands_skipped.increment();
+                    }
+                    latest = &sample.data();
+                    latest_writer = sample.info().publication_handle();
+                    latest_reception_ns = reception_ns;
+                } else {
+                    actuator.command(sample.data().position());
+                    reaction.sample_applied(sample.info().publication_handle(), reception_ns);
+                }
             }
         }
     }
-
-    return;
+    if (latest != NULL) {
+        actuator.command(latest->position());
+        reaction.sample_applied(latest_writer, latest_reception_ns);
+    }
 } // The LoanedSamples destructor returns the loan
 
 void handle_status(dds::sub::DataReader<actuation::SteeringDesired> reader,
-                   dds::pub::DataWriter<actuation::SteeringActual> writer){
+                   SteeringActuator& actuator,
+                   ColumnMetrics& metrics,
+                   failover::ReactionTimer& reaction){
     bool safety_position(false);
+    int64_t now_ns = latency::system_now_ns();
 
     dds::core::status::StatusMask status_mask = reader.status_changes();
 
     // Check for incompatible status
     if((status_mask & dds::core::status::StatusMask::requested_incompatible_qos()).any()) {
         auto requested_incompatible_qos_status = reader.requested_incompatible_qos_status();
-            std::cout << std::left << std::setw(OUTPUT_WIDTH) << std::setfill(' ')
-                      << "Requested Incompatible QoS by controller: "
-                      << requested_incompatible_qos_status.last_policy_id() << std::endl;
+            eventlog::record(
+                eventlog::incompatible_qos,
+                dds::core::InstanceHandle::nil(),
+                requested_incompatible_qos_status.last_policy_id());
     }
 
     // Check for liveliness status
     if ((status_mask & dds::core::status::StatusMask::liveliness_changed()).any()) {
         auto liveliness_status = reader.liveliness_changed_status();
+        metrics.liveliness_changes.increment();
         if (liveliness_status.not_alive_count_change() > 0) {
-            std::cout << std::left << std::setw(OUTPUT_WIDTH) << std::setfill(' ')
-                      << "Liveliness changed for controller:" << liveliness_status.last_publication_handle()
-                      << " (active " << liveliness_status.alive_count()
-                      << ", inactive " << liveliness_status.not_alive_count() << ")" << std::endl;
+            eventlog::record(
+                eventlog::liveliness_lost,
+                liveliness_status.last_publication_handle(),
+                liveliness_status.alive_count(),
+                liveliness_status.not_alive_count());
+            reaction.writer_lost(liveliness_status.last_publication_handle(), now_ns);
         }
         if (liveliness_status.alive_count() == 0) {
             safety_position = true;
@@ -80,13 +421,17 @@ void handle_status(dds::sub::DataReader<actuation::SteeringDesired> reader,
     if((status_mask & dds::core::status::StatusMask::subscription_matched()).any()) {
         auto subscription_status = reader.subscription_matched_status();
         if (subscription_status.current_count_change() > 0) {
-            std::cout << std::left << std::setw(OUTPUT_WIDTH) << std::setfill(' ')
-                      << "Matched controller:" << subscription_status.last_publication_handle()
-                      << " (count " << subscription_status.current_count() << ")" << std::endl;
+            column_profiler().mark("controller discovered");
+            eventlog::record(
+                eventlog::controller_matched,
+                subscription_status.last_publication_handle(),
+                subscription_status.current_count());
         } else {
-            std::cout << std::left << std::setw(OUTPUT_WIDTH) << std::setfill(' ')
-                      << "Unmatched controller:" << subscription_status.last_publication_handle()
-                      << " (count " << subscription_status.current_count() << ")" << std::endl;
+            eventlog::record(
+                eventlog::controller_unmatched,
+                subscription_status.last_publication_handle(),
+                subscription_status.current_count());
+            reaction.writer_lost(subscription_status.last_publication_handle(), now_ns);
         }
         if( subscription_status.current_count() == 0) {
             safety_position = true;
@@ -96,17 +441,165 @@ void handle_status(dds::sub::DataReader<actuation::SteeringDesired> reader,
     // Check for deadline status
     if((status_mask & dds::core::status::StatusMask::requested_deadline_missed()).any()) {
         auto deadline_status = reader.requested_deadline_missed_status();
-        std::cout << "Deadline missed!" << std::endl;
+        metrics.deadline_misses.increment(deadline_status.total_count_change());
+        eventlog::record(eventlog::deadline_missed);
+        reaction.owner_lost(now_ns);
     }
 
     // Steer to neutral position if there are no active controllers:
     if(safety_position) {
-        writer.write(actuation::SteeringActual(0));
-        std::cout << "Steering to Neutral Position: 0" << std::endl;
+        actuator.steer_to_neutral();
+        metrics.safety_activations.increment();
+        eventlog::record(eventlog::steered_to_neutral);
     }
 }
 
-void run_publisher_application(unsigned int domain_id)
+// One steering column (of one vehicle): its command reader and status
+// writer, the state of its actuator, and the conditions a control loop
+// dispatches for it
+class Column {
+public:
+    Column(
+        dds::sub::DataReader<actuation::SteeringDesired> command_reader,
+        dds::pub::DataWriter<actuation::SteeringActual> status_writer,
+        const application::ApplicationArguments& arguments,
+        ColumnMetrics& metrics,
+        trace::Recorder& recorder,
+        watchdog::Watchdog& watchdog,
+        size_t watchdog_channel)
+        : command_reader_(command_reader),
+        watchdog_(watchdog),
+        watchdog_channel_(watchdog_channel),
+        watchdog_trip_ns_(0),
+        status_publisher_(
+            status_writer,
+            arguments.deadband,
+            arguments.keepalive_ms,
+            metrics,
+            recorder,
+            arguments.link),
+        model_(arguments.slew_rate, arguments.max_acceleration),
+        // Simulate the column dynamics at a fixed rate, if requested
+        actuator_(status_publisher_, arguments.model_rate > 0 ? &model_ : NULL),
+        // Create a ReadCondition for any data received on this reader and
+        // set a handler to process the data
+        read_condition_(
+            command_reader,
+            dds::sub::status::DataState::new_data(),
+            [this, &metrics, &recorder, &arguments, &watchdog, watchdog_channel]() {
+                int64_t start_ns = latency::now_ns();
+                report_watchdog_trip();
+                process_data(
+                    command_reader_,
+                    actuator_,
+                    arguments.latest_only,
+                    static_cast<int64_t>(arguments.max_age_us) * 1000,
+                    metrics,
+                    recorder,
+                    reaction_,
+                    watchdog,
+                    watchdog_channel);
+                metrics.dispatch_duration.record(latency::now_ns() - start_ns);
+                column_profiler().finish("first actuation", std::cout);
+            }),
+        status_condition_(command_reader)
+    {
+        // Enable the statuses to monitor
+        status_condition_.enabled_statuses(
+            dds::core::status::StatusMask::requested_incompatible_qos() |
+            dds::core::status::StatusMask::subscription_matched() |
+            dds::core::status::StatusMask::requested_deadline_missed() |
+            dds::core::status::StatusMask::liveliness_changed());
+
+        // Set a handler for the StatusCondition
+        status_condition_.extensions().handler([this, &metrics]() {
+            int64_t start_ns = latency::now_ns();
+            report_watchdog_trip();
+            handle_status(command_reader_, actuator_, metrics, reaction_);
+            report_safe_state();
+            metrics.dispatch_duration.record(latency::now_ns() - start_ns);
+        });
+    }
+
+    // Returns the number of conditions attached
+    size_t attach(dds::core::cond::WaitSet& waitset)
+    {
+        waitset += read_condition_;
+        waitset += status_condition_;
+        return 2;
+    }
+
+    // Called from the control loop after each dispatch
+    void keep_alive()
+    {
+        report_watchdog_trip();
+        actuator_.keep_alive();
+    }
+
+    // Called from the watchdog thread when the commands stopped, with the
+    // deadline missed (on latency::now_ns()). The commands re-arm the
+    // watchdog before they are applied, so a command that arrived since it
+    // expired wins; returns whether it steered.
+    bool watchdog_expired(int64_t deadline_ns)
+    {
+        bool steered = actuator_.steer_to_neutral_if([this]() {
+            return !watchdog_.armed(watchdog_channel_);
+        });
+        if (steered) {
+            // The controller was lost at the deadline, on the clock of the
+            // reaction timer
+            watchdog_trip_ns_.store(
+                    latency::system_now_ns() - (latency::now_ns() - deadline_ns));
+        }
+        return steered;
+    }
+
+    // Called from the model thread
+    void step_model(float dt)
+    {
+        actuator_.publish_model_position(model_.step(dt));
+    }
+
+    const StatusPublisher& status_publisher() const { return status_publisher_; }
+    const failover::ReactionTimer& reaction() const { return reaction_; }
+
+private:
+    // Times the loss of the controller at a watchdog trip, on the control
+    // loop (the reaction timer is not shared with the watchdog thread); the
+    // safe state is timed when neutral is published
+    void report_watchdog_trip()
+    {
+        int64_t lost_ns = watchdog_trip_ns_.exchange(0);
+        if (lost_ns != 0) {
+            reaction_.owner_lost(lost_ns);
+        }
+        report_safe_state();
+    }
+
+    // Times the safe state once the neutral position was published, on the
+    // control loop (with the model, it is published from the model thread)
+    void report_safe_state()
+    {
+        int64_t safe_state_ns = actuator_.take_safe_state_ns();
+        if (safe_state_ns != 0) {
+            reaction_.safe_state(safe_state_ns);
+        }
+    }
+
+    dds::sub::DataReader<actuation::SteeringDesired> command_reader_;
+    watchdog::Watchdog& watchdog_;
+    size_t watchdog_channel_;
+    std::atomic<int64_t> watchdog_trip_ns_;  // loss, on system_now_ns(), 0 if none
+    StatusPublisher status_publisher_;
+    ActuatorModel model_;
+    SteeringActuator actuator_;
+    // Times the reactions to the loss of the primary controller
+    failover::ReactionTimer reaction_;
+    dds::sub::cond::ReadCondition read_condition_;
+    dds::core::cond::StatusCondition status_condition_;
+};
+
+void run_column_application(const application::ApplicationArguments& arguments)
 {
     // DDS objects behave like shared pointers or value types
     // (see https://community.rti.com/best-practices/use-modern-c-types-correctly)
@@ -117,9 +610,14 @@ void run_publisher_application(unsigned int domain_id)
     rti::domain::register_type<actuation::SteeringActual>("rti::actuation::SteeringActual");
     rti::domain::register_type<actuation::SteeringDesired>("rti::actuation::SteeringDesired");
 
+    // Log the events of the handlers from a background thread, up to the
+    // severity of the --verbosity
+    eventlog::Session log_session(arguments.verbosity);
+
     // Create the participant, changing the domain id from the one in the
     // configuration
-    rti::domain::DomainParticipantConfigParams params(domain_id);
+    rti::domain::DomainParticipantConfigParams params(arguments.domain_id);
+    column_profiler().mark("types registered");
 
     // Create the participant
     auto default_provider = dds::core::QosProvider::Default();
@@ -127,6 +625,9 @@ void run_publisher_application(unsigned int domain_id)
     default_provider->create_participant_from_config(
         "SteeringParticipantLib::SteeringColumn",
         params);
+    transport::configure(participant, arguments.transport);
+    transport::configure_discovery(participant, arguments.peers, arguments.fast_discovery);
+    column_profiler().mark("participant created");
 
     // Lookup the DataWriter from the configuration
     dds::pub::DataWriter<actuation::SteeringActual> status_writer =
@@ -134,51 +635,207 @@ void run_publisher_application(unsigned int domain_id)
         participant,
         "outputs::Steering_writer");
 
+    // Filter the status on the writer side for displays with a time-based
+    // or delta filter (see SteeringDisplay), however many there are, so
+    // that the samples they skip are never sent
+    filter::register_delta_filter<actuation::SteeringActual>(participant);
+    auto status_writer_qos = status_writer.qos();
+    status_writer_qos << rti::core::policy::DataWriterResourceLimits()
+            .max_remote_reader_filters(dds::core::LENGTH_UNLIMITED);
+    status_writer.qos(status_writer_qos);
+
     // Lookup the DataReader from the configuration
     dds::sub::DataReader<actuation::SteeringDesired> command_reader =
     rti::sub::find_datareader_by_name<dds::sub::DataReader<actuation::SteeringDesired>>(
         participant,
         "inputs::Steering_reader");
 
-    // Create a ReadCondition for any data received on this reader and set a
-    // handler to process the data
-    dds::sub::cond::ReadCondition read_condition(
-        command_reader,
-        dds::sub::status::DataState::new_data(),
-        [command_reader, status_writer]() { process_data(command_reader, status_writer); });
-
-    // Enable the statuses to monitor
-    dds::core::cond::StatusCondition status_condition(command_reader);
-    status_condition.enabled_statuses(
-        dds::core::status::StatusMask::requested_incompatible_qos() |
-        dds::core::status::StatusMask::subscription_matched() |
-        dds::core::status::StatusMask::requested_deadline_missed() |
-        dds::core::status::StatusMask::liveliness_changed());
-
-    // Set a handler for the StatusCondition
-    status_condition.extensions().handler([command_reader, status_writer]() {
-        handle_status(command_reader, status_writer);
-    });
-
-    // WaitSet will be woken when the attached condition is triggered
-    dds::core::cond::WaitSet waitset;
-    waitset += read_condition;
-    waitset += status_condition;
+    // Override the liveliness lease and deadline, if requested
+    auto command_reader_qos = command_reader.qos();
+    failover::override_timing(command_reader_qos, arguments.lease_ms, arguments.deadline_ms);
+    command_reader.qos(command_reader_qos);
+
+    // Record the steering traffic, if requested
+    ColumnMetrics metrics;
+    trace::Recorder recorder;
+    if (!arguments.trace_file.empty()) {
+        recorder.open(arguments.trace_file);
+    }
+
+    // Steer to neutral when a column gets no command within the budget,
+    // if requested
+    watchdog::Watchdog watchdog(
+        static_cast<int64_t>(arguments.watchdog_us) * 1000,
+        arguments.vehicles == 0 ? 1 : arguments.vehicles);
+
+    // One column, or a column per vehicle of a fleet, each in the partition
+    // of its vehicle and with DataWriters and DataReaders like the
+    // configured ones (which are then deleted before they are enabled)
+    std::vector<std::unique_ptr<Column>> columns;
+    if (arguments.vehicles == 0) {
+        columns.push_back(std::unique_ptr<Column>(new Column(
+            command_reader, status_writer, arguments, metrics, recorder, watchdog, 0)));
+    } else {
+        for (unsigned int vehicle = 0; vehicle < arguments.vehicles; vehicle++) {
+            columns.push_back(std::unique_ptr<Column>(new Column(
+                fleet::create_reader(command_reader, vehicle),
+                fleet::create_writer(status_writer, vehicle),
+                arguments,
+                metrics,
+                recorder,
+                watchdog,
+                vehicle)));
+        }
+        command_reader.close();
+        status_writer.close();
+        std::cout << "Serving " << columns.size() << " vehicles" << std::endl;
+    }
+
+    // Lock and pre-fault memory before the middleware starts its threads
+    if (arguments.lock_memory) {
+        realtime::lock_memory();
+    }
+
+    // Periodically export the metrics, if requested
+    metrics::Exporter metrics_exporter(arguments.metrics_file, arguments.metrics_period_ms);
+
+    column_profiler().mark("entities created");
 
     // Enable the participant and underlying entities recursively
     participant.enable();
+    column_profiler().mark("participant enabled");
+
+    // The watchdog runs above the control loops, so that it fires on time
+    // even when they are busy
+    watchdog.start(
+        [&columns, &metrics](size_t channel, int64_t deadline_ns) {
+            if (columns[channel]->watchdog_expired(deadline_ns)) {
+                metrics.safety_activations.increment();
+                eventlog::record(eventlog::watchdog_tripped, dds::core::InstanceHandle::nil(), channel);
+            }
+        },
+        arguments.priority > 0 ? std::min(arguments.priority + 1, 99) : 0);
+
+    // With a deadband, wake up at least once per keep-alive period
+    const StatusPublisher& status_publisher = columns.front()->status_publisher();
+    dds::core::Duration dispatch_timeout = status_publisher.keepalive_enabled()
+            ? status_publisher.keepalive_period()
+            : dds::core::Duration::from_secs(10);
+
+    // Run the control loops on dedicated threads with the requested
+    // scheduling priority and CPU affinity. The columns are shared out
+    // between the workers, each with its own WaitSet; worker <n> is pinned
+    // to CPU <cpu + n>.
+    size_t worker_count = std::max<size_t>(1, std::min<size_t>(arguments.workers, columns.size()));
+    int64_t start_ns = latency::now_ns();
+    int64_t start_cpu_ns = latency::cpu_ns();
+    std::vector<std::thread> control_threads;
+    for (size_t worker = 0; worker < worker_count; worker++) {
+        control_threads.push_back(std::thread(
+            [&columns, &arguments, worker, worker_count, dispatch_timeout]() {
+            realtime::configure_thread(
+                arguments.priority,
+                arguments.cpu >= 0 ? arguments.cpu + static_cast<int>(worker) : -1);
+            if (arguments.lock_memory) {
+                realtime::prefault_stack();
+            }
+
+            // WaitSet will be woken when an attached condition is triggered
+            dds::core::cond::WaitSet waitset;
+            waitset += application::shutdown_condition();
+            size_t condition_count = 1;
+            for (size_t i = worker; i < columns.size(); i += worker_count) {
+                condition_count += columns[i]->attach(waitset);
+            }
+            application::Dispatcher dispatcher(waitset, condition_count);
+
+            std::cout << "Actuator loop starting..." << std::endl;
+            while (!application::shutdown_requested) {
+                dispatcher.dispatch(dispatch_timeout);
+                for (size_t i = worker; i < columns.size(); i += worker_count) {
+                    columns[i]->keep_alive();
+                }
+            }
+        }));
+    }
+
+    // The model publishes the actual position on its own clock, decoupled
+    // from the rate of the commands. It runs one priority below the
+    // control loops, pinned to the CPU after theirs (<cpu + workers>), so
+    // that neither adds jitter to the other.
+    std::thread model_thread;
+    if (arguments.model_rate > 0) {
+        model_thread = std::thread([&columns, &arguments, worker_count]() {
+            realtime::configure_thread(
+                arguments.priority > 1 ? arguments.priority - 1 : arguments.priority,
+                arguments.cpu >= 0 ? arguments.cpu + static_cast<int>(worker_count) : -1);
+
+            periodic::Executor executor(arguments.model_rate);
+            float dt = executor.period_ns() / 1e9f;
+            while (!application::shutdown_requested) {
+                for (size_t i = 0; i < columns.size(); i++) {
+                    columns[i]->step_model(dt);
+                }
+                executor.wait_next();
+            }
+            std::cout << "Actuator model: ";
+            executor.print_statistics(std::cout);
+        });
+    }
 
-    std::cout << "Actuator loop starting..." << std::endl;
-    while (!application::shutdown_requested) {
-        waitset.dispatch(dds::core::Duration::from_secs(10));
+    for (size_t worker = 0; worker < control_threads.size(); worker++) {
+        control_threads[worker].join();
+    }
+    if (model_thread.joinable()) {
+        model_thread.join();
+    }
+    watchdog.stop();
+
+    double seconds = (latency::now_ns() - start_ns) / 1e9;
+    double cpu_seconds = (latency::cpu_ns() - start_cpu_ns) / 1e9;
+    std::cout << "Commands taken: " << metrics.samples_taken.value()
+              << " (" << metrics.samples_taken.value() / seconds << " per second)"
+              << std::endl;
+    std::cout << "Status samples written: " << metrics.samples_written.value()
+              << ", suppressed by deadband: " << metrics.samples_suppressed.value()
+              << ", commands coalesced (latest-only): " << metrics.commands_skipped.value() << std::endl;
+    if (arguments.max_age_us > 0) {
+        std::cout << "Commands older than " << arguments.max_age_us << " us dropped: "
+                  << metrics.commands_stale.value() << std::endl;
+    }
+    std::cout << "Actuator CPU time: " << cpu_seconds << " s ("
+              << cpu_seconds * 100.0 / seconds << "% of one core)" << std::endl;
+    metrics.dispatch_latency.snapshot().print(std::cout, "Dispatch latency (us):", 1000.0);
+    metrics.command_age.snapshot().print(std::cout, "Command age (us):", 1000.0);
+    std::cout << "Deadline misses: " << metrics.deadline_misses.value()
+              << ", liveliness changes: " << metrics.liveliness_changes.value()
+              << ", safe-state activations: " << metrics.safety_activations.value()
+              << std::endl;
+    failover::ReactionTimer reaction;
+    for (size_t i = 0; i < columns.size(); i++) {
+        reaction.add(columns[i]->reaction());
+    }
+    reaction.print_statistics(std::cout);
+    watchdog.print_statistics(std::cout);
+    for (size_t i = 0; i < columns.size(); i++) {
+        columns[i]->status_publisher().print_statistics(std::cout);
+    }
+    if (recorder.is_open()) {
+        std::cout << "Trace records dropped: " << recorder.dropped() << std::endl;
     }
 }
 
+// The launcher (SteeringLauncher.cxx) and the benchmarks (see bench/)
+// include this file without its main()
+#ifndef STEERING_NO_MAIN
 int main(int argc, char *argv[])
 {
 
     using namespace application;
 
+    // Time the startup from here
+    column_profiler();
+
     // Parse arguments and handle control-C
     auto arguments = parse_arguments(argc, argv);
     if (arguments.parse_result == ParseReturn::exit) {
@@ -192,10 +849,10 @@ int main(int argc, char *argv[])
     rti::config::Logger::instance().verbosity(arguments.verbosity);
 
     try {
-        run_publisher_application(arguments.domain_id);
+        run_column_application(arguments);
     } catch (const std::exception& ex) {
         // This will catch DDS exceptions
-        std::cerr << "Exception in run_publisher_application(): " << ex.what()
+        std::cerr << "Exception in run_column_application(): " << ex.what()
         << std::endl;
         return EXIT_FAILURE;
     }
@@ -206,3 +863,5 @@ int main(int argc, char *argv[])
 
     return EXIT_SUCCESS;
 }
+
+#endif  // STEERING_NO_MAIN
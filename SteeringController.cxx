@@ -11,6 +11,10 @@
 */
 
 #include <iostream>
+#include <iomanip>
+#include <cmath>    // For std::fabs
+#include <vector>
+#include <memory>
 
 #include <dds/pub/ddspub.hpp>
 #include <dds/sub/ddssub.hpp>
@@ -27,10 +31,396 @@
 //    https://community.rti.com/static/documentation/connext-dds/7.3.0/doc/api/connext_dds/api_cpp2/group__DDSCpp2Conventions.html
 
 #include "application.hpp"  // for command line parsing and ctrl-c
+#include "latency.hpp"      // for round-trip measurements
+#include "periodic.hpp"     // for the fixed-rate publish loop
+#include "transport.hpp"    // for shared memory and reused samples
+#include "metrics.hpp"      // for counters and histograms
+#include "trace.hpp"        // for recording the steering traffic
+#include "failover.hpp"     // for the liveliness and deadline overrides
+#include "fleet.hpp"        // for the vehicle partitions
+#include "startup.hpp"      // for the startup profile
+#include "eventlog.hpp"     // for logging off the write loop
+#include "control.hpp"      // for the closed-loop kernel
+#include "netsim.hpp"       // for the scripted crash
 #include "Steering_t.hpp"
 using namespace rti;
 
-void run_publisher_application(unsigned int domain_id, unsigned int strength)
+// The startup profile of this app, or of this component of the launcher;
+// the first call starts it (at the top of main())
+startup::Profiler& controller_profiler()
+{
+    static startup::Profiler instance("SteeringController");
+    return instance;
+}
+
+// Matches the echoed status samples against the outstanding benchmark
+// commands. Returns the number of round trips completed.
+int process_status(
+    dds::sub::DataReader<actuation::SteeringActual> reader,
+    latency::RoundTripTracker& tracker,
+    latency::Histogram& histogram,
+    bool measuring,
+    metrics::ComponentMetrics& metrics)
+{
+    int64_t receive_ns = latency::now_ns();
+    int count = 0;
+
+    // Take all samples
+    dds::sub::LoanedSamples<actuation::SteeringActual> samples = reader.take();
+    for (const auto& sample : samples) {
+        if (sample.info().valid()) {
+            metrics.samples_taken.increment();
+            int64_t round_trip_ns = tracker.match(sample.data().position(), receive_ns);
+            if (round_trip_ns >= 0) {
+                count++;
+                if (measuring) {
+                    histogram.record(round_trip_ns);
+                }
+            }
+        }
+    }
+
+    return count;
+} // The LoanedSamples destructor returns the loan
+
+// Writes stamped commands one at a time and waits for the actuator to echo
+// each one back on the status reader, recording the round-trip time
+void run_latency_benchmark(
+    dds::pub::DataWriter<actuation::SteeringDesired> command_writer,
+    dds::sub::DataReader<actuation::SteeringActual> status_reader,
+    unsigned int sample_count,
+    unsigned int warmup_count,
+    metrics::ComponentMetrics& metrics,
+    trace::Recorder& recorder)
+{
+    const int64_t echo_timeout_ns = 1000000000;
+
+    latency::RoundTripTracker tracker;
+    latency::Histogram histogram;
+    unsigned int samples_lost = 0;
+    bool echoed = false;
+    bool measuring = false;
+
+    // Create a ReadCondition for the echoed status and set a handler to
+    // match it against the outstanding commands
+    dds::sub::cond::ReadCondition read_condition(
+        status_reader,
+        dds::sub::status::DataState::new_data(),
+        [status_reader, &tracker, &histogram, &echoed, &measuring, &metrics]() {
+            int64_t start_ns = latency::now_ns();
+            if (process_status(status_reader, tracker, histogram, measuring, metrics) > 0) {
+                echoed = true;
+            }
+            metrics.dispatch_duration.record(latency::now_ns() - start_ns);
+        });
+
+    dds::core::cond::WaitSet waitset;
+    waitset += read_condition;
+    waitset += application::shutdown_condition();
+    application::Dispatcher dispatcher(waitset, 2);
+
+    // The actuator must be matched in both directions before measuring
+    std::cout << "Waiting for the actuator..." << std::endl;
+    while (!application::shutdown_requested
+            && (command_writer.publication_matched_status().current_count() == 0
+            || status_reader.subscription_matched_status().current_count() == 0)) {
+        rti::util::sleep(dds::core::Duration::from_millisecs(100));
+    }
+
+    std::cout << "Benchmark starting: " << warmup_count << " warm-up, "
+              << sample_count << " measured samples" << std::endl;
+    transport::SampleWriter<actuation::SteeringDesired> sample_writer(command_writer);
+    for (unsigned int i = 0;
+            i < warmup_count + sample_count && !application::shutdown_requested;
+            i++) {
+        measuring = (i >= warmup_count);
+        echoed = false;
+
+        int64_t send_ns = latency::now_ns();
+        float position = tracker.stamp(send_ns);
+        sample_writer.write(position);
+        metrics.samples_written.increment();
+        recorder.record(trace::command_sent, position, latency::system_now_ns());
+
+        // Wait for the echo, or give up on this sample
+        int64_t remaining_ns = echo_timeout_ns;
+        while (!echoed && remaining_ns > 0 && !application::shutdown_requested) {
+            dispatcher.dispatch(dds::core::Duration::from_microsecs(remaining_ns / 1000));
+            remaining_ns = echo_timeout_ns - (latency::now_ns() - send_ns);
+        }
+        if (!echoed) {
+            tracker.cancel(position);
+            if (measuring) {
+                samples_lost++;
+            }
+        }
+    }
+
+    std::cout << "Round-trip latency in microseconds ("
+              << samples_lost << " lost):" << std::endl;
+    histogram.print(std::cout, "controller->actuator->controller", 1000.0);
+}
+
+// Streams stamped commands at 'rate' for 'seconds' while matching the
+// echoes of the actuator, and reports what the current publication mode
+// (synchronous, batched or asynchronous) costs: CPU time and UDP datagrams
+// per sample, and the round-trip latency it adds
+void run_stream_benchmark(
+    transport::SampleWriter<actuation::SteeringDesired>& sample_writer,
+    dds::sub::DataReader<actuation::SteeringActual> status_reader,
+    unsigned int rate,
+    unsigned int seconds,
+    metrics::ComponentMetrics& metrics,
+    trace::Recorder& recorder)
+{
+    latency::RoundTripTracker tracker;
+    latency::Histogram histogram;
+    unsigned int samples_echoed = 0;
+
+    // The echoes are matched between writes, on this thread
+    dds::sub::cond::ReadCondition read_condition(
+        status_reader,
+        dds::sub::status::DataState::new_data(),
+        [status_reader, &tracker, &histogram, &samples_echoed, &metrics]() {
+            samples_echoed += process_status(status_reader, tracker, histogram, true, metrics);
+        });
+
+    dds::core::cond::WaitSet waitset;
+    waitset += read_condition;
+    waitset += application::shutdown_condition();
+    application::Dispatcher dispatcher(waitset, 2);
+
+    std::cout << "Waiting for the actuator..." << std::endl;
+    while (!application::shutdown_requested
+            && (sample_writer.writer().publication_matched_status().current_count() == 0
+            || status_reader.subscription_matched_status().current_count() == 0)) {
+        rti::util::sleep(dds::core::Duration::from_millisecs(100));
+    }
+
+    std::cout << "Streaming " << rate << " commands per second for "
+              << seconds << " s" << std::endl;
+    const int64_t period_ns = 1000000000LL / (rate > 0 ? rate : 1);
+    const unsigned int sample_count = rate * seconds;
+    unsigned int samples_written = 0;
+    int64_t start_cpu_ns = latency::cpu_ns();
+    int64_t start_datagrams = transport::udp_datagrams_sent();
+    int64_t start_ns = latency::now_ns();
+    for (; samples_written < sample_count && !application::shutdown_requested;
+            samples_written++) {
+        int64_t send_ns = latency::now_ns();
+        float position = tracker.stamp(send_ns);
+        sample_writer.write(position);
+        metrics.samples_written.increment();
+        recorder.record(trace::command_sent, position, latency::system_now_ns());
+
+        // Match the echoes until the next write is due
+        int64_t next_ns = start_ns + (samples_written + 1) * period_ns;
+        for (int64_t remaining_ns = next_ns - latency::now_ns();
+                remaining_ns > 0 && !application::shutdown_requested;
+                remaining_ns = next_ns - latency::now_ns()) {
+            dispatcher.dispatch(dds::core::Duration::from_microsecs(remaining_ns / 1000));
+        }
+    }
+    int64_t elapsed_ns = latency::now_ns() - start_ns;
+    int64_t cpu_ns = latency::cpu_ns() - start_cpu_ns;
+    int64_t datagrams = transport::udp_datagrams_sent() - start_datagrams;
+
+    // Wait a little for the last batches and echoes
+    int64_t drain_end_ns = latency::now_ns() + 1000000000LL;
+    while (samples_echoed < samples_written && !application::shutdown_requested
+            && latency::now_ns() < drain_end_ns) {
+        dispatcher.dispatch(dds::core::Duration::from_millisecs(100));
+    }
+
+    std::ios::fmtflags flags(std::cout.flags());
+    std::cout << std::fixed << std::setprecision(2)
+              << "Samples written: " << samples_written << " in " << elapsed_ns / 1e9
+              << " s, echoed: " << samples_echoed << std::endl;
+    if (samples_written > 0) {
+        std::cout << "CPU time per sample (us): "
+                  << cpu_ns / 1e3 / samples_written << std::endl;
+        if (start_datagrams >= 0) {
+            std::cout << "UDP datagrams per second: " << datagrams * 1e9 / elapsed_ns
+                      << ", per sample: " << static_cast<double>(datagrams) / samples_written
+                      << std::endl;
+        }
+    }
+    std::cout.flags(flags);
+    histogram.print(std::cout, "Round-trip latency (us):", 1000.0);
+}
+
+// Amplitude (degrees) and period (seconds) of the closed-loop reference
+const float REFERENCE_AMPLITUDE = 90.0f;
+const float REFERENCE_PERIOD_S = 4.0f;
+
+// Steers along a reference trajectory in closed loop: every cycle takes the
+// latest actual position reported by the actuator, and writes the command
+// of the PID kernel. Once running, a cycle neither allocates nor locks
+// (unless it writes through a simulated link, see netsim.hpp).
+class ClosedLoop {
+public:
+    ClosedLoop(
+        transport::SampleWriter<actuation::SteeringDesired>& sample_writer,
+        dds::sub::DataReader<actuation::SteeringActual> status_reader,
+        const application::ApplicationArguments& arguments,
+        metrics::ComponentMetrics& metrics,
+        trace::Recorder& recorder)
+        : sample_writer_(sample_writer),
+        status_reader_(status_reader),
+        pid_(arguments.kp,
+            arguments.ki,
+            arguments.kd,
+            1.0f / (arguments.rate > 0 ? arguments.rate : 1),
+            180.0f),
+        trajectory_(REFERENCE_AMPLITUDE, REFERENCE_PERIOD_S),
+        start_ns_(latency::now_ns()),
+        measured_(0.0f),
+        received_(false),
+        metrics_(metrics),
+        recorder_(recorder) {}
+
+    // Runs one control cycle; returns the command written
+    float cycle()
+    {
+        int64_t start_ns = latency::now_ns();
+
+        // The latest actual position, if any arrived since the last cycle
+        bool fresh = false;
+        dds::sub::LoanedSamples<actuation::SteeringActual> samples = status_reader_.take();
+        for (const auto& sample : samples) {
+            if (sample.info().valid()) {
+                metrics_.samples_taken.increment();
+                measured_ = sample.data().position();
+                received_ = true;
+                fresh = true;
+            }
+        }
+
+        // Until the actuator reports, follow the reference in open loop
+        float reference = trajectory_.at((start_ns - start_ns_) / 1e9);
+        float command = received_ ? pid_.step(reference, measured_, fresh) : reference;
+        sample_writer_.write(command);
+        metrics_.samples_written.increment();
+        recorder_.record(trace::command_sent, command, latency::system_now_ns());
+
+        int64_t loop_ns = latency::now_ns() - start_ns;
+        metrics_.dispatch_duration.record(loop_ns);
+        loop_time_.record(loop_ns);
+        if (received_) {
+            float error = reference - measured_;
+            // In thousandths of a degree
+            tracking_error_.record(static_cast<int64_t>(std::fabs(error) * 1000.0f));
+            eventlog::record(
+                eventlog::control_cycle,
+                dds::core::InstanceHandle::nil(),
+                loop_ns,
+                0,
+                error);
+        }
+        return command;
+    }
+
+    void print_statistics(std::ostream& out) const
+    {
+        tracking_error_.print(out, "Tracking error (deg):", 1000.0);
+        loop_time_.print(out, "Loop time (us):", 1000.0);
+    }
+
+private:
+    transport::SampleWriter<actuation::SteeringDesired>& sample_writer_;
+    dds::sub::DataReader<actuation::SteeringActual> status_reader_;
+    control::Pid pid_;
+    control::SineTrajectory trajectory_;
+    int64_t start_ns_;
+    float measured_;
+    bool received_;
+    latency::Histogram tracking_error_;
+    latency::Histogram loop_time_;
+    metrics::ComponentMetrics& metrics_;
+    trace::Recorder& recorder_;
+};
+
+// Runs the closed loop at the control rate until the shutdown, then reports
+// the tracking error and the execution time of the cycles
+void run_closed_loop(
+    transport::SampleWriter<actuation::SteeringDesired>& sample_writer,
+    dds::sub::DataReader<actuation::SteeringActual> status_reader,
+    const application::ApplicationArguments& arguments,
+    metrics::ComponentMetrics& metrics,
+    trace::Recorder& recorder)
+{
+    std::cout << "Closed loop at " << arguments.rate << " Hz, gains "
+              << arguments.kp << ", " << arguments.ki << ", " << arguments.kd << std::endl;
+    ClosedLoop closed_loop(sample_writer, status_reader, arguments, metrics, recorder);
+    netsim::CrashSchedule crash_schedule(arguments.crash_after_ms);
+    periodic::Executor executor(arguments.rate);
+    // Log about once per second, whatever the rate
+    unsigned int print_period = arguments.rate > 0 ? arguments.rate : 1;
+
+    for (unsigned int cycles = 0; !application::shutdown_requested; cycles++) {
+        float command = closed_loop.cycle();
+        if (cycles % print_period == 0) {
+            eventlog::record(
+                eventlog::command_written,
+                dds::core::InstanceHandle::nil(),
+                0,
+                0,
+                command);
+        }
+        controller_profiler().mark("first command written");
+        if (!controller_profiler().finished()
+                && sample_writer.writer().publication_matched_status().current_count() > 0) {
+            controller_profiler().finish("actuator discovered", std::cout);
+        }
+        crash_schedule.check();
+        executor.wait_next();
+    }
+
+    executor.print_statistics(std::cout);
+    closed_loop.print_statistics(std::cout);
+    sample_writer.print_statistics(std::cout);
+}
+
+typedef transport::SampleWriter<actuation::SteeringDesired> CommandWriter;
+
+// One cycle of the open-loop write loop: writes the position of the
+// 'cycle' through every writer (one per vehicle)
+void write_commands(
+    unsigned int cycle,
+    unsigned int print_period,
+    std::vector<std::unique_ptr<CommandWriter>>& sample_writers,
+    metrics::ComponentMetrics& metrics,
+    trace::Recorder& recorder,
+    const netsim::CrashSchedule& crash_schedule)
+{
+    int64_t start_ns = latency::now_ns();
+
+    // Modify the data to be written here
+    // Shift to the range: -180 to +180
+    float position = (cycle + 180) % 360 - 180.0f;
+    if (cycle % print_period == 0) {
+        eventlog::record(
+            eventlog::command_written,
+            dds::core::InstanceHandle::nil(),
+            0,
+            0,
+            position);
+    }
+    for (size_t i = 0; i < sample_writers.size(); i++) {
+        sample_writers[i]->write(position);
+        metrics.samples_written.increment();
+        recorder.record(trace::command_sent, position, latency::system_now_ns());
+    }
+    controller_profiler().mark("first command written");
+    if (!controller_profiler().finished()
+            && sample_writers.front()->writer().publication_matched_status().current_count() > 0) {
+        controller_profiler().finish("actuator discovered", std::cout);
+    }
+    metrics.dispatch_duration.record(latency::now_ns() - start_ns);
+    crash_schedule.check();
+}
+
+void run_controller_application(const application::ApplicationArguments& arguments)
 {
     // DDS objects behave like shared pointers or value types
     // (see https://community.rti.com/best-practices/use-modern-c-types-correctly)
@@ -41,9 +431,14 @@ void run_publisher_application(unsigned int domain_id, unsigned int strength)
     rti::domain::register_type<actuation::SteeringDesired>("rti::actuation::SteeringDesired");
     rti::domain::register_type<actuation::SteeringActual>("rti::actuation::SteeringActual");
 
+    // Log the events of the write loop from a background thread, up to the
+    // severity of the --verbosity
+    eventlog::Session log_session(arguments.verbosity);
+
     // Create the participant, changing the domain id from the one in the
     // configuration
-    rti::domain::DomainParticipantConfigParams params(domain_id);
+    rti::domain::DomainParticipantConfigParams params(arguments.domain_id);
+    controller_profiler().mark("types registered");
 
     // Create the participant
     auto default_provider = dds::core::QosProvider::Default();
@@ -51,6 +446,9 @@ void run_publisher_application(unsigned int domain_id, unsigned int strength)
     default_provider->create_participant_from_config(
         "SteeringParticipantLib::SteeringController",
         params);
+    transport::configure(participant, arguments.transport);
+    transport::configure_discovery(participant, arguments.peers, arguments.fast_discovery);
+    controller_profiler().mark("participant created");
 
     // Lookup the DataWriter from the configuration
     dds::pub::DataWriter<actuation::SteeringDesired> command_writer =
@@ -60,7 +458,13 @@ void run_publisher_application(unsigned int domain_id, unsigned int strength)
 
     // Set strength of the DataWriter
     auto command_writer_qos = command_writer.qos();
-    command_writer_qos << dds::core::policy::OwnershipStrength(strength);
+    command_writer_qos << dds::core::policy::OwnershipStrength(arguments.strength);
+    failover::override_timing(command_writer_qos, arguments.lease_ms, arguments.deadline_ms);
+    // Batch and publish asynchronously, if requested
+    rti::pub::FlowController flow_controller = transport::configure_publication(
+        participant,
+        command_writer_qos,
+        arguments);
     command_writer.qos(command_writer_qos);
 
     // Lookup the DataReader from the configuration
@@ -69,28 +473,100 @@ void run_publisher_application(unsigned int domain_id, unsigned int strength)
         participant,
         "inputs::Steering_reader");
 
+    // Periodically export the metrics, if requested
+    metrics::ComponentMetrics metrics("SteeringController");
+    metrics::Exporter metrics_exporter(arguments.metrics_file, arguments.metrics_period_ms);
+
+    // Record the commands written, if requested
+    trace::Recorder recorder;
+    if (!arguments.trace_file.empty()) {
+        recorder.open(arguments.trace_file);
+    }
+
+    // Drive one vehicle, or each vehicle of a fleet through a DataWriter
+    // in its partition
+    std::vector<std::unique_ptr<CommandWriter>> sample_writers;
+    if (arguments.vehicles == 0) {
+        sample_writers.push_back(std::unique_ptr<CommandWriter>(
+            new CommandWriter(command_writer, arguments.link)));
+    } else {
+        for (unsigned int vehicle = 0; vehicle < arguments.vehicles; vehicle++) {
+            sample_writers.push_back(std::unique_ptr<CommandWriter>(
+                new CommandWriter(
+                    fleet::create_writer(command_writer, vehicle),
+                    arguments.link)));
+        }
+        command_writer.close();
+        std::cout << "Driving " << sample_writers.size() << " vehicles" << std::endl;
+    }
+
+    controller_profiler().mark("entities created");
+
     // Enable the participant and underlying entities recursively
     participant.enable();
+    controller_profiler().mark("participant enabled");
+
+    if ((arguments.benchmark_samples > 0 || arguments.stream_seconds > 0
+            || arguments.closed_loop) && arguments.vehicles > 0) {
+        std::cout << "The benchmarks and the closed loop drive one vehicle: ignoring "
+                  << "--benchmark, --stream and --closed-loop" << std::endl;
+    } else if (arguments.closed_loop) {
+        run_closed_loop(
+            *sample_writers.front(),
+            status_reader,
+            arguments,
+            metrics,
+            recorder);
+        return;
+    } else if (arguments.stream_seconds > 0) {
+        run_stream_benchmark(
+            *sample_writers.front(),
+            status_reader,
+            arguments.rate,
+            arguments.stream_seconds,
+            metrics,
+            recorder);
+        return;
+    } else if (arguments.benchmark_samples > 0) {
+        run_latency_benchmark(
+            command_writer,
+            status_reader,
+            arguments.benchmark_samples,
+            arguments.warmup_samples,
+            metrics,
+            recorder);
+        return;
+    }
+
+    netsim::CrashSchedule crash_schedule(arguments.crash_after_ms);
+    periodic::Executor executor(arguments.rate);
+    // Print about once per second, whatever the rate
+    unsigned int print_period = arguments.rate > 0 ? arguments.rate : 1;
 
-    actuation::SteeringDesired data;
     // Main loop, write data
-    for (unsigned int samples_written = 0; !application::shutdown_requested; samples_written++) {
-        // Modify the data to be written here
-        // Shift to the range: -180 to +180
-        data.position((samples_written + 180) % 360 - 180.0);
-        std::cout << "Writing Steering Position: " << data.position() << std::endl;
-        command_writer.write(data);
+    for (unsigned int cycle = 0; !application::shutdown_requested; cycle++) {
+        write_commands(cycle, print_period, sample_writers, metrics, recorder, crash_schedule);
 
-        // Wait 1 second
-         rti::util::sleep(dds::core::Duration::from_secs(1));
+        // Wait for the next period
+        executor.wait_next();
+    }
+
+    executor.print_statistics(std::cout);
+    for (size_t i = 0; i < sample_writers.size(); i++) {
+        sample_writers[i]->print_statistics(std::cout);
     }
 }
 
+// The launcher (SteeringLauncher.cxx) includes this file without its main()
+#ifndef STEERING_NO_MAIN
 int main(int argc, char *argv[])
 {
 
     using namespace application;
 
+    // Time the startup from here
+    controller_profiler();
+
     // Parse arguments and handle control-C
     auto arguments = parse_arguments(argc, argv);
     if (arguments.parse_result == ParseReturn::exit) {
@@ -104,10 +580,10 @@ int main(int argc, char *argv[])
     rti::config::Logger::instance().verbosity(arguments.verbosity);
 
     try {
-        run_publisher_application(arguments.domain_id, arguments.strength);
+        run_controller_application(arguments);
     } catch (const std::exception& ex) {
         // This will catch DDS exceptions
-        std::cerr << "Exception in run_publisher_application(): " << ex.what()
+        std::cerr << "Exception in run_controller_application(): " << ex.what()
         << std::endl;
         return EXIT_FAILURE;
     }
@@ -118,3 +594,5 @@ int main(int argc, char *argv[])
 
     return EXIT_SUCCESS;
 }
+
+#endif  // STEERING_NO_MAIN
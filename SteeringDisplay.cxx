@@ -11,6 +11,10 @@
 */
 
 #include <iostream>
+#include <iomanip>  // For std::setw
+#include <sstream>
+#include <thread>
+#include <vector>
 
 #include <dds/sub/ddssub.hpp>
 #include <dds/core/ddscore.hpp>
@@ -26,26 +30,187 @@
 //    https://community.rti.com/static/documentation/connext-dds/7.3.0/doc/api/connext_dds/api_cpp2/group__DDSCpp2Conventions.html
 
 #include "application.hpp"  // for command line parsing and ctrl-c
+#include "transport.hpp"    // for shared memory
+#include "periodic.hpp"     // for the fixed frame rate
+#include "ring_buffer.hpp"  // for handing samples to the render thread
+#include "metrics.hpp"      // for counters and histograms
+#include "fleet.hpp"        // for the vehicle partitions
+#include "filter.hpp"       // for the delta filter
+#include "eventlog.hpp"     // for logging off the dispatch thread
+#include "startup.hpp"      // for the startup profile
 
 #include "Steering_t.hpp"
 using namespace rti;
 
-int process_data(dds::sub::DataReader< actuation::SteeringActual> reader)
+// The startup profile of this app, or of this component of the launcher;
+// the first call starts it (at the top of main())
+startup::Profiler& display_profiler()
 {
+    static startup::Profiler instance("SteeringDisplay");
+    return instance;
+}
+
+// A received steering status, as handed over to the render thread
+struct DisplaySample {
+    unsigned int vehicle;
+    float position;
+    int64_t receive_ns;
+};
+
+typedef ring_buffer::SpscRing<DisplaySample> DisplayRing;
+
+// Metrics collected by the display
+struct DisplayMetrics : metrics::ComponentMetrics {
+    DisplayMetrics()
+        : metrics::ComponentMetrics("SteeringDisplay"),
+        samples_dropped(
+            "steering_display_samples_dropped_total",
+            "Samples dropped because the render thread fell behind",
+            "SteeringDisplay") {}
+
+    metrics::Counter samples_dropped;
+};
+
+int process_data(
+    dds::sub::DataReader< actuation::SteeringActual> reader,
+    unsigned int vehicle,
+    DisplayRing& ring,
+    DisplayMetrics& metrics)
+{
+    int64_t receive_ns = latency::now_ns();
+
     // Take all samples
     int count = 0;
     dds::sub::LoanedSamples< actuation::SteeringActual> samples = reader.take();
-    for (auto sample : samples) {
+    for (const auto& sample : samples) {
         if (sample.info().valid()) {
             count++;
-            std::cout << "Steering Column Position: " << sample.data().position() << std::endl;
+            metrics.samples_taken.increment();
+            // Never wait for the render thread: drop the sample if it is
+            // behind
+            DisplaySample display_sample = { vehicle, sample.data().position(), receive_ns };
+            if (!ring.push(display_sample)) {
+                metrics.samples_dropped.increment();
+                eventlog::record(eventlog::status_dropped, dds::core::InstanceHandle::nil(), vehicle);
+            }
         }
     }
 
     return count;
 } // The LoanedSamples destructor returns the loan
 
-void run_subscriber_application(unsigned int domain_id)
+// Redraws the dashboard at a fixed frame rate from the samples queued by
+// the dispatch thread, so that console output never delays sample intake
+void render_dashboard(
+    DisplayRing& ring,
+    const DisplayMetrics& metrics,
+    unsigned int frame_rate)
+{
+    periodic::Executor executor(frame_rate);
+    DisplaySample display_sample = { 0, 0.0f, 0 };
+    bool received = false;
+    uint64_t samples_in_window = 0;
+    int64_t window_start_ns = latency::now_ns();
+    double sample_rate = 0.0;
+    std::stringstream line;
+    line << std::fixed << std::setprecision(1);
+    const std::string empty;
+
+    while (!application::shutdown_requested) {
+        while (ring.pop(display_sample)) {
+            received = true;
+            samples_in_window++;
+        }
+
+        // Update the sample rate about once per second
+        int64_t now_ns = latency::now_ns();
+        if (now_ns - window_start_ns >= 1000000000LL) {
+            sample_rate = samples_in_window * 1e9 / (now_ns - window_start_ns);
+            samples_in_window = 0;
+            window_start_ns = now_ns;
+        }
+
+        // Draw the line in a buffer and write it at once, so that the
+        // formatting never changes std::cout for the logger thread
+        line.str(empty);
+        line << "\rSteering Column Position: "
+             << std::setw(7) << display_sample.position
+             << (received ? "" : " (none)")
+             << " | " << std::setw(8) << sample_rate << " samples/s"
+             << " | dropped " << metrics.samples_dropped.value()
+             << "   ";
+        std::cout << line.str() << std::flush;
+
+        executor.wait_next();
+    }
+    std::cout << std::endl;
+}
+
+// Redraws a table of the latest position of every vehicle of a fleet, in
+// place, at a fixed frame rate
+void render_fleet(
+    DisplayRing& ring,
+    const DisplayMetrics& metrics,
+    unsigned int frame_rate,
+    unsigned int vehicles)
+{
+    const unsigned int VEHICLES_PER_ROW = 8;
+
+    periodic::Executor executor(frame_rate);
+    DisplaySample display_sample = { 0, 0.0f, 0 };
+    std::vector<float> positions(vehicles, 0.0f);
+    std::vector<bool> received(vehicles, false);
+    uint64_t samples_in_window = 0;
+    int64_t window_start_ns = latency::now_ns();
+    double sample_rate = 0.0;
+    // Each frame is built in the same buffer, which grows to the size of a
+    // frame in the first frames and is then reused
+    std::stringstream frame;
+    const std::string empty;
+
+    std::cout << "\033[2J";  // clear the screen
+    while (!application::shutdown_requested) {
+        while (ring.pop(display_sample)) {
+            if (display_sample.vehicle < vehicles) {
+                positions[display_sample.vehicle] = display_sample.position;
+                received[display_sample.vehicle] = true;
+            }
+            samples_in_window++;
+        }
+
+        // Update the sample rate about once per second
+        int64_t now_ns = latency::now_ns();
+        if (now_ns - window_start_ns >= 1000000000LL) {
+            sample_rate = samples_in_window * 1e9 / (now_ns - window_start_ns);
+            samples_in_window = 0;
+            window_start_ns = now_ns;
+        }
+
+        // Draw the whole frame at once, from the top left corner
+        frame.str(empty);
+        frame << std::fixed << std::setprecision(1)
+              << "\033[HSteering Column Positions: " << vehicles << " vehicles"
+              << " | " << std::setw(8) << sample_rate << " samples/s"
+              << " | dropped " << metrics.samples_dropped.value() << "\033[K";
+        for (unsigned int vehicle = 0; vehicle < vehicles; vehicle++) {
+            if (vehicle % VEHICLES_PER_ROW == 0) {
+                frame << "\033[K\n";
+            }
+            frame << std::setw(6) << vehicle << ":";
+            if (received[vehicle]) {
+                frame << std::setw(7) << positions[vehicle];
+            } else {
+                frame << std::setw(7) << "-";
+            }
+        }
+        std::cout << frame.rdbuf() << "\033[K" << std::flush;
+
+        executor.wait_next();
+    }
+    std::cout << std::endl;
+}
+
+void run_display_application(const application::ApplicationArguments& arguments)
 {
     // DDS objects behave like shared pointers or value types
     // (see https://community.rti.com/best-practices/use-modern-c-types-correctly)
@@ -55,9 +220,14 @@ void run_subscriber_application(unsigned int domain_id)
     // in your system
     rti::domain::register_type<actuation::SteeringActual>("rti::actuation::SteeringActual");
 
+    // Log the events of the handlers from a background thread, up to the
+    // severity of the --verbosity
+    eventlog::Session log_session(arguments.verbosity);
+
     // Create the participant, changing the domain id from the one in the
     // configuration
-    rti::domain::DomainParticipantConfigParams params(domain_id);
+    rti::domain::DomainParticipantConfigParams params(arguments.domain_id);
+    display_profiler().mark("types registered");
 
     // Create the participant
     auto default_provider = dds::core::QosProvider::Default();
@@ -65,6 +235,9 @@ void run_subscriber_application(unsigned int domain_id)
         default_provider->create_participant_from_config(
         "SteeringParticipantLib::SteeringDisplay",
         params);
+    transport::configure(participant, arguments.transport);
+    transport::configure_discovery(participant, arguments.peers, arguments.fast_discovery);
+    display_profiler().mark("participant created");
 
     // Lookup the DataReader from the configuration
     dds::sub::DataReader<actuation::SteeringActual> status_reader =
@@ -72,33 +245,120 @@ void run_subscriber_application(unsigned int domain_id)
         participant,
         "inputs::Steering_reader");
 
-    // Create a ReadCondition for any data received on this reader and set a
-    // handler to process the data
+    // Receive no more status than rendered: the actuator skips the samples
+    // within the minimum separation of the last one sent to this display
+    if (arguments.min_separation_ms > 0) {
+        dds::sub::qos::DataReaderQos status_reader_qos = status_reader.qos();
+        status_reader_qos << dds::core::policy::TimeBasedFilter(
+            dds::core::Duration::from_millisecs(arguments.min_separation_ms));
+        status_reader.qos(status_reader_qos);
+    }
+
+    // Display one vehicle, or each vehicle of a fleet through a DataReader
+    // in its partition. With a minimum change, the readers subscribe to
+    // the delta filter of the status topic instead.
+    std::vector<dds::sub::DataReader<actuation::SteeringActual>> status_readers;
+    if (arguments.min_change > 0.0f) {
+        dds::topic::ContentFilteredTopic<actuation::SteeringActual> delta_topic =
+            filter::create_delta_topic(status_reader, arguments.min_change);
+        if (arguments.vehicles == 0) {
+            status_readers.push_back(dds::sub::DataReader<actuation::SteeringActual>(
+                status_reader.subscriber(),
+                delta_topic,
+                status_reader.qos()));
+        } else {
+            for (unsigned int vehicle = 0; vehicle < arguments.vehicles; vehicle++) {
+                status_readers.push_back(
+                    fleet::create_reader(status_reader, vehicle, delta_topic));
+            }
+        }
+        status_reader.close();
+    } else if (arguments.vehicles == 0) {
+        status_readers.push_back(status_reader);
+    } else {
+        for (unsigned int vehicle = 0; vehicle < arguments.vehicles; vehicle++) {
+            status_readers.push_back(fleet::create_reader(status_reader, vehicle));
+        }
+        status_reader.close();
+    }
+
+    // Samples are handed over to the render thread through a ring buffer
+    // sized for one second of a 1 kHz stream per vehicle
+    DisplayRing ring(1024 * status_readers.size());
+    DisplayMetrics metrics;
+
+    // Create a ReadCondition for any data received on each reader and set
+    // a handler to process the data
     unsigned int samples_read = 0;
-    dds::sub::cond::ReadCondition read_condition(
-        status_reader,
-        dds::sub::status::DataState::any(),
-        [status_reader, &samples_read]() { samples_read += process_data(status_reader); });
+    std::vector<dds::sub::cond::ReadCondition> read_conditions;
+    for (unsigned int vehicle = 0; vehicle < status_readers.size(); vehicle++) {
+        dds::sub::DataReader<actuation::SteeringActual> reader = status_readers[vehicle];
+        read_conditions.push_back(dds::sub::cond::ReadCondition(
+            reader,
+            dds::sub::status::DataState::any(),
+            [reader, vehicle, &samples_read, &ring, &metrics]() {
+                int64_t start_ns = latency::now_ns();
+                samples_read += process_data(reader, vehicle, ring, metrics);
+                metrics.dispatch_duration.record(latency::now_ns() - start_ns);
+                display_profiler().finish("first status received", std::cout);
+            }));
+    }
 
-    // WaitSet will be woken when the attached condition is triggered
+    // WaitSet will be woken when an attached condition is triggered
     dds::core::cond::WaitSet waitset;
-    waitset += read_condition;
+    waitset += application::shutdown_condition();
+    for (size_t i = 0; i < read_conditions.size(); i++) {
+        waitset += read_conditions[i];
+    }
+
+    // Periodically export the metrics, if requested
+    metrics::Exporter metrics_exporter(arguments.metrics_file, arguments.metrics_period_ms);
+
+    display_profiler().mark("entities created");
 
     // Enable the participant and underlying entities recursively
     participant.enable();
+    display_profiler().mark("participant enabled");
 
     std::cout << "Display starting..." << std::endl;
+    std::thread render_thread;
+    if (arguments.vehicles == 0) {
+        render_thread = std::thread(
+            render_dashboard,
+            std::ref(ring),
+            std::cref(metrics),
+            arguments.frame_rate);
+    } else {
+        render_thread = std::thread(
+            render_fleet,
+            std::ref(ring),
+            std::cref(metrics),
+            arguments.frame_rate,
+            arguments.vehicles);
+    }
+
+    application::Dispatcher dispatcher(waitset, read_conditions.size() + 1);
     while (!application::shutdown_requested) {
         // Run the handlers of the active conditions. Wait for up to 1 second.
-        waitset.dispatch(dds::core::Duration(1));
+        dispatcher.dispatch(dds::core::Duration(1));
     }
+
+    render_thread.join();
+    std::cout << "Samples read: " << samples_read
+              << ", dropped by the display: " << metrics.samples_dropped.value() << std::endl;
 }
 
+// The launcher (SteeringLauncher.cxx) and the benchmarks (see bench/)
+// include this file without its main()
+#ifndef STEERING_NO_MAIN
 int main(int argc, char *argv[])
 {
 
     using namespace application;
 
+    // Time the startup from here
+    display_profiler();
+
     // Parse arguments and handle control-C
     auto arguments = parse_arguments(argc, argv);
     if (arguments.parse_result == ParseReturn::exit) {
@@ -112,10 +372,10 @@ int main(int argc, char *argv[])
     rti::config::Logger::instance().verbosity(arguments.verbosity);
 
     try {
-        run_subscriber_application(arguments.domain_id);
+        run_display_application(arguments);
     } catch (const std::exception& ex) {
         // This will catch DDS exceptions
-        std::cerr << "Exception in run_subscriber_application(): " << ex.what()
+        std::cerr << "Exception in run_display_application(): " << ex.what()
         << std::endl;
         return EXIT_FAILURE;
     }
@@ -126,3 +386,5 @@ int main(int argc, char *argv[])
 
     return EXIT_SUCCESS;
 }
+
+#endif  // STEERING_NO_MAIN
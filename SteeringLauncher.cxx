@@ -0,0 +1,128 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+// Runs the SteeringController, SteeringColumn and SteeringDisplay as
+// components of a single process (e.g. on one ECU), each on its own thread
+// and with its own participant, created by the participant factory of the
+// process. The participants are those of the apps, so the components
+// exchange data through a transport (shared memory by default), not
+// within one participant.
+#define STEERING_NO_MAIN
+#include "SteeringController.cxx"
+#include "SteeringColumn.cxx"
+#include "SteeringDisplay.cxx"
+
+typedef void (*ComponentFunction)(const application::ApplicationArguments&);
+
+// Runs a component until the shutdown. If it fails, or returns on its own
+// and 'last' (e.g. at the end of a controller benchmark), the whole process
+// shuts down.
+void run_component(
+    const char *name,
+    ComponentFunction component,
+    const application::ApplicationArguments& arguments,
+    bool last)
+{
+    try {
+        component(arguments);
+    } catch (const std::exception& ex) {
+        // This will catch DDS exceptions
+        std::cerr << "Exception in " << name << "(): " << ex.what() << std::endl;
+        last = true;
+    }
+    if (last && !application::shutdown_requested) {
+        application::stop_handler(0);
+    }
+}
+
+void run_launcher_application(const application::ApplicationArguments& arguments)
+{
+    // The components exchange data over shared memory, unless another
+    // transport is requested
+    application::ApplicationArguments component_arguments = arguments;
+    if (component_arguments.transport == application::Transport::configured) {
+        component_arguments.transport = application::Transport::shmem;
+    }
+
+    // The metrics of all the components are exported together, below; only
+    // the actuator records the trace, which holds both the commands and the
+    // status
+    component_arguments.metrics_file.clear();
+    application::ApplicationArguments controller_arguments = component_arguments;
+    controller_arguments.trace_file.clear();
+
+    metrics::Exporter metrics_exporter(arguments.metrics_file, arguments.metrics_period_ms);
+
+    // Start the actuator and the display before the controller, so that its
+    // first commands are not lost to discovery
+    bool benchmark = arguments.benchmark_samples > 0 || arguments.stream_seconds > 0;
+    std::thread column_thread(
+        run_component,
+        "run_column_application",
+        run_column_application,
+        std::cref(component_arguments),
+        false);
+    std::thread display_thread(
+        run_component,
+        "run_display_application",
+        run_display_application,
+        std::cref(component_arguments),
+        false);
+    std::thread controller_thread(
+        run_component,
+        "run_controller_application",
+        run_controller_application,
+        std::cref(controller_arguments),
+        benchmark);
+
+    controller_thread.join();
+    column_thread.join();
+    display_thread.join();
+}
+
+int main(int argc, char *argv[])
+{
+
+    using namespace application;
+
+    // Time the startup from here; each component prints its own profile
+    controller_profiler();
+    column_profiler();
+    display_profiler();
+
+    // Parse arguments and handle control-C
+    auto arguments = parse_arguments(argc, argv);
+    if (arguments.parse_result == ParseReturn::exit) {
+        return EXIT_SUCCESS;
+    } else if (arguments.parse_result == ParseReturn::failure) {
+        return EXIT_FAILURE;
+    }
+    setup_signal_handlers();
+
+    // Sets Connext verbosity to help debugging
+    rti::config::Logger::instance().verbosity(arguments.verbosity);
+
+    try {
+        run_launcher_application(arguments);
+    } catch (const std::exception& ex) {
+        // This will catch DDS exceptions
+        std::cerr << "Exception in run_launcher_application(): " << ex.what()
+        << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Releases the memory used by the participant factory.  Optional at
+    // application exit
+    dds::domain::DomainParticipant::finalize_participant_factory();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,709 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cmath>
+
+#include <dds/pub/ddspub.hpp>
+#include <dds/sub/ddssub.hpp>
+#include <rti/util/util.hpp>      // for sleep()
+#include <rti/config/Logger.hpp>  // for logging
+// alternatively, to include all the standard APIs:
+//  <dds/dds.hpp>
+// or to include both the standard APIs and extensions:
+//  <rti/rti.hpp>
+//
+// For more information about the headers and namespaces, see:
+//    https://community.rti.com/static/documentation/connext-dds/7.3.0/doc/api/connext_dds/api_cpp2/group__DDSNamespaceModule.html
+// For information on how to use extensions, see:
+//    https://community.rti.com/static/documentation/connext-dds/7.3.0/doc/api/connext_dds/api_cpp2/group__DDSCpp2Conventions.html
+
+#include "application.hpp"  // for command line parsing and ctrl-c
+#include "latency.hpp"      // for failover time measurements
+#include "periodic.hpp"     // for sleep_until()
+#include "transport.hpp"    // for shared memory and reused samples
+#include "metrics.hpp"      // for counters and histograms
+#include "failover.hpp"     // for the liveliness and deadline overrides
+#include "Steering_t.hpp"
+using namespace rti;
+
+// Every command carries the index of its writer in the fraction of the
+// position, so that the status echoed by the actuator tells which writer
+// owns it: position = angle + (index + 1) / OWNER_TAG_RESOLUTION.
+// The neutral position (no fraction) is the safe state. Each writer ramps
+// its angle by one degree per command, from -180 to 179.
+const float OWNER_TAG_RESOLUTION = 256.0f;
+const size_t MAX_WRITERS = 255;
+const int SAFE_STATE = -1;
+const int RAMP_DEGREES = 360;
+
+// An actuator that echoes the commands moves one ramp step at a time for
+// most of its statuses; none in this many means that it does not
+const uint64_t MAX_STEPS_WITHOUT_ECHO = 100;
+
+// Without a scenario, the strongest writer left is killed every step
+const int64_t CASCADE_STEP_MS = 2000;
+
+inline float tag_position(float angle, size_t writer)
+{
+    return angle + (writer + 1) / OWNER_TAG_RESOLUTION;
+}
+
+inline float ramp_angle(uint64_t sample)
+{
+    return static_cast<float>((sample + RAMP_DEGREES / 2) % RAMP_DEGREES) - RAMP_DEGREES / 2;
+}
+
+// Decodes the writer and the angle of an echoed command, or the safe
+// state; returns false if the position is not one (e.g. the intermediate
+// position of an actuator model)
+inline bool decode_position(float position, int& owner, int& angle)
+{
+    if (position == 0.0f) {
+        owner = SAFE_STATE;
+        angle = 0;
+        return true;
+    }
+    float tagged = position * OWNER_TAG_RESOLUTION;
+    if (tagged != std::floor(tagged)) {
+        return false;
+    }
+    angle = static_cast<int>(std::floor(position));
+    owner = static_cast<int>(std::lround((position - angle) * OWNER_TAG_RESOLUTION)) - 1;
+    return owner >= 0 && angle >= -RAMP_DEGREES / 2 && angle < RAMP_DEGREES / 2;
+}
+
+// A redundant controller run by the load generator
+struct WriterSpec {
+    int strength;
+    unsigned int rate_hz;
+};
+
+enum ScheduleAction {
+    kill_writer,    // delete the DataWriter: the actuator sees it leave
+    revive_writer,  // create the DataWriter again
+    stall_writer,   // keep the DataWriter, but stop writing (deadline)
+    resume_writer
+};
+
+struct ScheduleEvent {
+    int64_t at_ms;
+    size_t writer;
+    ScheduleAction action;
+};
+
+inline bool event_before(const ScheduleEvent& left, const ScheduleEvent& right)
+{
+    return left.at_ms < right.at_ms;
+}
+
+// Reads a scenario file: one writer per line, as
+//     <strength> <rate_hz> [kill@<ms>|revive@<ms>|stall@<ms>|resume@<ms>]...
+// with the times relative to the start of the run. '#' starts a comment.
+void load_scenario(
+    const std::string& path,
+    std::vector<WriterSpec>& writers,
+    std::vector<ScheduleEvent>& events)
+{
+    std::ifstream in(path.c_str());
+    if (!in) {
+        throw std::runtime_error("cannot read scenario " + path);
+    }
+
+    std::string line;
+    for (int line_number = 1; std::getline(in, line); line_number++) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        WriterSpec spec;
+        if (!(fields >> spec.strength)) {
+            continue;  // blank line
+        }
+        if (!(fields >> spec.rate_hz) || spec.rate_hz == 0) {
+            throw std::runtime_error(
+                path + ":" + std::to_string(line_number) + ": bad rate");
+        }
+
+        std::string token;
+        while (fields >> token) {
+            size_t at = token.find('@');
+            std::string action = token.substr(0, at);
+            ScheduleEvent event;
+            event.writer = writers.size();
+            event.at_ms = at == std::string::npos ? -1 : atoll(token.c_str() + at + 1);
+            if (action == "kill") {
+                event.action = kill_writer;
+            } else if (action == "revive") {
+                event.action = revive_writer;
+            } else if (action == "stall") {
+                event.action = stall_writer;
+            } else if (action == "resume") {
+                event.action = resume_writer;
+            } else {
+                event.at_ms = -1;
+            }
+            if (event.at_ms < 0) {
+                throw std::runtime_error(
+                    path + ":" + std::to_string(line_number) + ": bad event " + token);
+            }
+            events.push_back(event);
+        }
+        writers.push_back(spec);
+    }
+}
+
+// Builds the default scenario: 'count' writers of increasing strength, all
+// at the same rate. The strongest writer left is killed every step, so that
+// the ownership fails over through all of them down to the safe state,
+// then all of them are revived at once.
+void cascade_scenario(
+    unsigned int count,
+    int base_strength,
+    unsigned int rate_hz,
+    std::vector<WriterSpec>& writers,
+    std::vector<ScheduleEvent>& events)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        WriterSpec spec = { base_strength + static_cast<int>(i), rate_hz };
+        writers.push_back(spec);
+    }
+    for (unsigned int step = 0; step < count; step++) {
+        ScheduleEvent event = { (step + 1) * CASCADE_STEP_MS, count - 1 - step, kill_writer };
+        events.push_back(event);
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        ScheduleEvent event = { (count + 1) * CASCADE_STEP_MS, i, revive_writer };
+        events.push_back(event);
+    }
+}
+
+// Follows the ownership of the actuator through its status, and measures
+// how long it takes to fail over when the owner stops writing. This only
+// holds if the actuator echoes each command it applies: the monitor
+// refuses the status of an actuator model (positions that are no command)
+// or of a deadband (the same owner never moving by one step). Updated by
+// the scheduler (writers lost and back) and by the status reader.
+class FailoverMonitor {
+public:
+    explicit FailoverMonitor(const std::vector<WriterSpec>& writers)
+        : writers_(writers),
+        writing_(writers.size(), true),
+        owned_(writers.size(), 0),
+        owner_(SAFE_STATE),
+        last_angle_(0),
+        refusal_(NULL),
+        owner_steps_(0),
+        echoed_steps_(0),
+        lost_owner_ns_(-1),
+        status_count_(0),
+        safe_count_(0),
+        ownership_changes_(0),
+        unexpected_owners_(0),
+        safe_states_(0) {}
+
+    // A writer was killed or stalled
+    void writer_lost(size_t writer, int64_t now_ns)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writing_[writer] = false;
+        if (static_cast<int>(writer) == owner_ && lost_owner_ns_ < 0) {
+            lost_owner_ns_ = now_ns;
+        }
+    }
+
+    // A writer was revived or resumed
+    void writer_back(size_t writer)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writing_[writer] = true;
+    }
+
+    // The actuator published 'position'
+    void observe(float position, int64_t now_ns)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        status_count_++;
+        int owner = SAFE_STATE;
+        int angle = 0;
+        if (!decode_position(position, owner, angle)
+                || (owner != SAFE_STATE && static_cast<size_t>(owner) >= owned_.size())) {
+            refuse("the actuator publishes positions that no load writer commanded"
+                   " (run it without --model-rate, and without other controllers)");
+            return;
+        }
+        if (owner == SAFE_STATE) {
+            safe_count_++;
+        } else {
+            owned_[owner]++;
+        }
+        if (owner == owner_) {
+            if (owner != SAFE_STATE) {
+                check_echo(angle);
+            }
+            return;
+        }
+        last_angle_ = angle;
+
+        ownership_changes_++;
+        if (lost_owner_ns_ >= 0) {
+            failover_.record(now_ns - lost_owner_ns_);
+            lost_owner_ns_ = -1;
+        }
+        if (strength_of(owner) != strength_of(expected_owner())) {
+            unexpected_owners_++;
+        }
+        if (owner == SAFE_STATE) {
+            safe_states_++;
+            std::cout << "Owner: none (safe state)" << std::endl;
+        } else {
+            std::cout << "Owner: writer " << owner
+                      << " (strength " << writers_[owner].strength << ")" << std::endl;
+        }
+        owner_ = owner;
+    }
+
+    uint64_t status_count()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return status_count_;
+    }
+
+    // Why the status cannot be attributed to the writers, or NULL
+    const char *refusal()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return refusal_;
+    }
+
+    void print_statistics(std::ostream& out, double seconds)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out << "Status samples received: " << status_count_
+            << " (" << status_count_ / seconds << " per second), "
+            << safe_count_ << " in the safe state" << std::endl;
+        for (size_t i = 0; i < writers_.size(); i++) {
+            out << "  writer " << i << " (strength " << writers_[i].strength
+                << ", " << writers_[i].rate_hz << " Hz) owned "
+                << owned_[i] << " samples" << std::endl;
+        }
+        out << "Ownership changes: " << ownership_changes_
+            << ", unexpected owners: " << unexpected_owners_
+            << ", safe states: " << safe_states_ << std::endl;
+        failover_.print(out, "Failover time (ms):", 1e6);
+    }
+
+private:
+    // Checks that the status of the same owner moves by one ramp step at a
+    // time, as its commands do (but for the commands lost or coalesced)
+    void check_echo(int angle)
+    {
+        int step = (angle - last_angle_ + RAMP_DEGREES) % RAMP_DEGREES;
+        last_angle_ = angle;
+        owner_steps_++;
+        if (step == 1) {
+            echoed_steps_++;
+        } else if (echoed_steps_ == 0 && owner_steps_ >= MAX_STEPS_WITHOUT_ECHO) {
+            refuse("the actuator does not publish every command it applies"
+                   " (run it without --deadband)");
+        }
+    }
+
+    void refuse(const char *reason)
+    {
+        if (refusal_ == NULL) {
+            refusal_ = reason;
+        }
+    }
+
+    // The strongest writer still writing
+    int expected_owner() const
+    {
+        int expected = SAFE_STATE;
+        for (size_t i = 0; i < writers_.size(); i++) {
+            if (writing_[i] && (expected == SAFE_STATE
+                    || writers_[i].strength > writers_[expected].strength)) {
+                expected = static_cast<int>(i);
+            }
+        }
+        return expected;
+    }
+
+    int strength_of(int owner) const
+    {
+        return owner == SAFE_STATE
+                ? std::numeric_limits<int>::min()
+                : writers_[owner].strength;
+    }
+
+    std::mutex mutex_;
+    std::vector<WriterSpec> writers_;
+    std::vector<bool> writing_;
+    std::vector<uint64_t> owned_;
+    int owner_;
+    int last_angle_;          // of the latest status of owner_
+    const char *refusal_;
+    uint64_t owner_steps_;    // between statuses of the same owner
+    uint64_t echoed_steps_;   // of one ramp step
+    int64_t lost_owner_ns_;
+    uint64_t status_count_;
+    uint64_t safe_count_;
+    uint64_t ownership_changes_;
+    uint64_t unexpected_owners_;
+    uint64_t safe_states_;
+    latency::Histogram failover_;
+};
+
+// One controller DataWriter, created, deleted and paused on schedule
+class LoadWriter {
+public:
+    LoadWriter(
+        size_t index,
+        const WriterSpec& spec,
+        dds::pub::Publisher publisher,
+        dds::topic::Topic<actuation::SteeringDesired> topic,
+        dds::pub::qos::DataWriterQos qos)
+        : index_(index),
+        period_ns_(1000000000LL / spec.rate_hz),
+        publisher_(publisher),
+        topic_(topic),
+        qos_(qos),
+        stalled_(false),
+        next_write_ns_(0),
+        samples_written_(0)
+    {
+        qos_ << dds::core::policy::OwnershipStrength(spec.strength);
+    }
+
+    void revive(int64_t now_ns)
+    {
+        if (!sample_writer_) {
+            sample_writer_.reset(new transport::SampleWriter<actuation::SteeringDesired>(
+                dds::pub::DataWriter<actuation::SteeringDesired>(publisher_, topic_, qos_)));
+        }
+        next_write_ns_ = now_ns;
+    }
+
+    void kill()
+    {
+        if (sample_writer_) {
+            sample_writer_->writer().close();
+            sample_writer_.reset();
+        }
+    }
+
+    void stall(bool stalled, int64_t now_ns)
+    {
+        stalled_ = stalled;
+        next_write_ns_ = now_ns;
+    }
+
+    bool writing() const { return sample_writer_ && !stalled_; }
+    int64_t next_write_ns() const { return next_write_ns_; }
+    uint64_t samples_written() const { return samples_written_; }
+
+    // Writes the next command of the ramp if it is due. Returns true if
+    // it wrote one.
+    bool write_due(int64_t now_ns)
+    {
+        if (!writing() || now_ns < next_write_ns_) {
+            return false;
+        }
+        sample_writer_->write(tag_position(ramp_angle(samples_written_), index_));
+        samples_written_++;
+
+        // Fixed rate: a late writer skips the missed periods
+        next_write_ns_ += period_ns_;
+        if (next_write_ns_ <= now_ns) {
+            next_write_ns_ = now_ns + period_ns_;
+        }
+        return true;
+    }
+
+private:
+    size_t index_;
+    int64_t period_ns_;
+    dds::pub::Publisher publisher_;
+    dds::topic::Topic<actuation::SteeringDesired> topic_;
+    dds::pub::qos::DataWriterQos qos_;
+    std::unique_ptr<transport::SampleWriter<actuation::SteeringDesired>> sample_writer_;
+    bool stalled_;
+    int64_t next_write_ns_;
+    uint64_t samples_written_;
+};
+
+// Attributes the status samples to the writer owning the actuator
+void process_status(
+    dds::sub::DataReader<actuation::SteeringActual> reader,
+    FailoverMonitor& monitor,
+    metrics::ComponentMetrics& metrics)
+{
+    int64_t receive_ns = latency::now_ns();
+
+    // Take all samples
+    dds::sub::LoanedSamples<actuation::SteeringActual> samples = reader.take();
+    for (const auto& sample : samples) {
+        if (sample.info().valid()) {
+            metrics.samples_taken.increment();
+            monitor.observe(sample.data().position(), receive_ns);
+        }
+    }
+} // The LoanedSamples destructor returns the loan
+
+void apply_event(
+    const ScheduleEvent& event,
+    LoadWriter& writer,
+    FailoverMonitor& monitor,
+    int64_t now_ns)
+{
+    switch (event.action) {
+    case kill_writer:
+        std::cout << "Killing writer " << event.writer << std::endl;
+        monitor.writer_lost(event.writer, now_ns);
+        writer.kill();
+        break;
+    case revive_writer:
+        std::cout << "Reviving writer " << event.writer << std::endl;
+        writer.revive(now_ns);
+        monitor.writer_back(event.writer);
+        break;
+    case stall_writer:
+        std::cout << "Stalling writer " << event.writer << std::endl;
+        monitor.writer_lost(event.writer, now_ns);
+        writer.stall(true, now_ns);
+        break;
+    case resume_writer:
+        std::cout << "Resuming writer " << event.writer << std::endl;
+        writer.stall(false, now_ns);
+        monitor.writer_back(event.writer);
+        break;
+    }
+}
+
+void run_load_application(const application::ApplicationArguments& arguments)
+{
+    // The writers to run and their schedule
+    std::vector<WriterSpec> specs;
+    std::vector<ScheduleEvent> events;
+    if (!arguments.scenario_file.empty()) {
+        load_scenario(arguments.scenario_file, specs, events);
+    } else {
+        cascade_scenario(arguments.writers, arguments.strength, arguments.rate, specs, events);
+    }
+    if (specs.empty() || specs.size() > MAX_WRITERS) {
+        throw std::invalid_argument(
+            "the load generator runs 1 to " + std::to_string(MAX_WRITERS)
+            + " writers (--scenario or --writers)");
+    }
+    for (size_t i = 0; i < events.size(); i++) {
+        if (events[i].writer >= specs.size()) {
+            throw std::invalid_argument("scenario event for an unknown writer");
+        }
+    }
+    std::stable_sort(events.begin(), events.end(), event_before);
+
+    // DDS objects behave like shared pointers or value types
+    // (see https://community.rti.com/best-practices/use-modern-c-types-correctly)
+
+    // When using user-generated types, you must register the type with RTI
+    // Connext DDS before creating the participants and the rest of the entities
+    // in your system
+    rti::domain::register_type<actuation::SteeringDesired>("rti::actuation::SteeringDesired");
+    rti::domain::register_type<actuation::SteeringActual>("rti::actuation::SteeringActual");
+
+    // Create the participant, changing the domain id from the one in the
+    // configuration
+    rti::domain::DomainParticipantConfigParams params(arguments.domain_id);
+
+    // All the writers share the participant of a controller
+    auto default_provider = dds::core::QosProvider::Default();
+    dds::domain::DomainParticipant participant =
+    default_provider->create_participant_from_config(
+        "SteeringParticipantLib::SteeringController",
+        params);
+    transport::configure(participant, arguments.transport);
+    transport::configure_discovery(participant, arguments.peers, arguments.fast_discovery);
+
+    // The configured DataWriter is the template of the load writers: keep
+    // its publisher, topic and QoS, and delete it before it is enabled
+    dds::pub::DataWriter<actuation::SteeringDesired> command_writer =
+    rti::pub::find_datawriter_by_name<dds::pub::DataWriter<actuation::SteeringDesired>>(
+        participant,
+        "outputs::Steering_writer");
+    dds::pub::Publisher publisher = command_writer.publisher();
+    dds::topic::Topic<actuation::SteeringDesired> command_topic = command_writer.topic();
+    dds::pub::qos::DataWriterQos command_writer_qos = command_writer.qos();
+    failover::override_timing(command_writer_qos, arguments.lease_ms, arguments.deadline_ms);
+    command_writer.close();
+
+    // Lookup the DataReader from the configuration
+    dds::sub::DataReader<actuation::SteeringActual> status_reader =
+    rti::sub::find_datareader_by_name<dds::sub::DataReader<actuation::SteeringActual>>(
+        participant,
+        "inputs::Steering_reader");
+
+    // Periodically export the metrics, if requested
+    metrics::ComponentMetrics metrics("SteeringLoad");
+    metrics::Exporter metrics_exporter(arguments.metrics_file, arguments.metrics_period_ms);
+
+    FailoverMonitor monitor(specs);
+
+    // Create a ReadCondition for the status and set a handler to follow
+    // the ownership of the actuator
+    dds::sub::cond::ReadCondition read_condition(
+        status_reader,
+        dds::sub::status::DataState::new_data(),
+        [status_reader, &monitor, &metrics]() {
+            process_status(status_reader, monitor, metrics);
+        });
+
+    dds::core::cond::WaitSet waitset;
+    waitset += read_condition;
+    waitset += application::shutdown_condition();
+
+    // Enable the participant and underlying entities recursively
+    participant.enable();
+
+    std::cout << "Waiting for the actuator..." << std::endl;
+    while (!application::shutdown_requested
+            && status_reader.subscription_matched_status().current_count() == 0) {
+        rti::util::sleep(dds::core::Duration::from_millisecs(100));
+    }
+
+    // The status is processed on its own thread, so that a burst of status
+    // never delays the writers
+    std::atomic<bool> running(true);
+    std::thread status_thread([&waitset, &running]() {
+        while (running && !application::shutdown_requested) {
+            waitset.dispatch(dds::core::Duration::from_millisecs(100));
+        }
+    });
+
+    int64_t start_ns = latency::now_ns();
+    std::vector<std::unique_ptr<LoadWriter>> writers;
+    for (size_t i = 0; i < specs.size(); i++) {
+        writers.push_back(std::unique_ptr<LoadWriter>(new LoadWriter(
+            i, specs[i], publisher, command_topic, command_writer_qos)));
+        writers[i]->revive(start_ns);
+    }
+    std::cout << "Running " << writers.size() << " writers" << std::endl;
+
+    // Run until the duration, or a step after the last scheduled event
+    int64_t end_ns = std::numeric_limits<int64_t>::max();
+    if (arguments.duration_s > 0) {
+        end_ns = start_ns + arguments.duration_s * 1000000000LL;
+    } else if (!events.empty()) {
+        end_ns = start_ns + (events.back().at_ms + CASCADE_STEP_MS) * 1000000LL;
+    }
+
+    // Schedule the writes and events of all the writers from this thread
+    size_t next_event = 0;
+    int64_t next_report_ns = start_ns + 1000000000LL;
+    uint64_t samples_written = 0;
+    uint64_t last_samples_written = 0;
+    uint64_t last_status_count = 0;
+    int64_t now_ns = start_ns;
+    const char *refusal = NULL;
+    while (!application::shutdown_requested && now_ns < end_ns) {
+        refusal = monitor.refusal();
+        if (refusal != NULL) {
+            break;
+        }
+        int64_t wake_ns = std::min(end_ns, next_report_ns);
+        if (next_event < events.size()) {
+            int64_t event_ns = start_ns + events[next_event].at_ms * 1000000LL;
+            wake_ns = std::min(wake_ns, event_ns);
+        }
+        for (size_t i = 0; i < writers.size(); i++) {
+            if (writers[i]->writing()) {
+                wake_ns = std::min(wake_ns, writers[i]->next_write_ns());
+            }
+        }
+        periodic::sleep_until(wake_ns);
+        now_ns = latency::now_ns();
+
+        while (next_event < events.size()
+                && start_ns + events[next_event].at_ms * 1000000LL <= now_ns) {
+            const ScheduleEvent& event = events[next_event++];
+            apply_event(event, *writers[event.writer], monitor, now_ns);
+        }
+
+        for (size_t i = 0; i < writers.size(); i++) {
+            if (writers[i]->write_due(now_ns)) {
+                samples_written++;
+                metrics.samples_written.increment();
+            }
+        }
+
+        if (now_ns >= next_report_ns) {
+            uint64_t status_count = monitor.status_count();
+            std::cout << "Commands written: " << samples_written - last_samples_written
+                      << "/s, status received: " << status_count - last_status_count
+                      << "/s" << std::endl;
+            last_samples_written = samples_written;
+            last_status_count = status_count;
+            next_report_ns += 1000000000LL;
+        }
+    }
+
+    running = false;
+    status_thread.join();
+    if (refusal != NULL) {
+        throw std::runtime_error(refusal);
+    }
+
+    double seconds = (latency::now_ns() - start_ns) / 1e9;
+    std::cout << "Commands written: " << samples_written
+              << " (" << samples_written / seconds << " per second)" << std::endl;
+    monitor.print_statistics(std::cout, seconds);
+}
+
+int main(int argc, char *argv[])
+{
+
+    using namespace application;
+
+    // Parse arguments and handle control-C
+    auto arguments = parse_arguments(argc, argv);
+    if (arguments.parse_result == ParseReturn::exit) {
+        return EXIT_SUCCESS;
+    } else if (arguments.parse_result == ParseReturn::failure) {
+        return EXIT_FAILURE;
+    }
+    setup_signal_handlers();
+
+    // Sets Connext verbosity to help debugging
+    rti::config::Logger::instance().verbosity(arguments.verbosity);
+
+    try {
+        run_load_application(arguments);
+    } catch (const std::exception& ex) {
+        // This will catch DDS exceptions
+        std::cerr << "Exception in run_load_application(): " << ex.what()
+        << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Releases the memory used by the participant factory.  Optional at
+    // application exit
+    dds::domain::DomainParticipant::finalize_participant_factory();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+#include <dds/pub/ddspub.hpp>
+#include <dds/sub/ddssub.hpp>
+#include <rti/util/util.hpp>      // for sleep()
+#include <rti/config/Logger.hpp>  // for logging
+// alternatively, to include all the standard APIs:
+//  <dds/dds.hpp>
+// or to include both the standard APIs and extensions:
+//  <rti/rti.hpp>
+//
+// For more information about the headers and namespaces, see:
+//    https://community.rti.com/static/documentation/connext-dds/7.3.0/doc/api/connext_dds/api_cpp2/group__DDSNamespaceModule.html
+// For information on how to use extensions, see:
+//    https://community.rti.com/static/documentation/connext-dds/7.3.0/doc/api/connext_dds/api_cpp2/group__DDSCpp2Conventions.html
+
+#include "application.hpp"  // for command line parsing and ctrl-c
+#include "latency.hpp"      // for timing accuracy measurements
+#include "periodic.hpp"     // for sleep_until()
+#include "transport.hpp"    // for shared memory and reused samples
+#include "trace.hpp"        // for reading the steering traffic
+#include "Steering_t.hpp"
+using namespace rti;
+
+// Re-publishes the steering commands of a trace recorded by a controller or
+// by the actuator, and the status written by the actuator if a status
+// writer is given, with their original timing scaled by 'speed'
+void replay_trace(
+    transport::SampleWriter<actuation::SteeringDesired>& command_writer,
+    transport::SampleWriter<actuation::SteeringActual> *status_writer,
+    const std::vector<trace::Record>& records,
+    double speed)
+{
+    latency::Histogram lateness;
+    unsigned int commands_written = 0;
+    unsigned int status_written = 0;
+
+    int64_t trace_start_ns = -1;
+    int64_t replay_start_ns = latency::now_ns();
+    for (size_t i = 0; i < records.size() && !application::shutdown_requested; i++) {
+        const trace::Record& record = records[i];
+        bool status = (record.kind == trace::status_written);
+        if (status ? status_writer == NULL
+                : record.kind != trace::command_sent && record.kind != trace::command_received) {
+            continue;
+        }
+        if (trace_start_ns < 0) {
+            trace_start_ns = record.timestamp_ns;
+        }
+
+        // Write each sample at its original offset from the first one (in
+        // double: a float would quantize the offsets of a long trace)
+        int64_t deadline_ns = replay_start_ns + static_cast<int64_t>(
+                static_cast<double>(record.timestamp_ns - trace_start_ns) / speed);
+        // A long gap between the records must not delay the shutdown
+        if (!periodic::sleep_until(deadline_ns, application::shutdown_requested)) {
+            break;
+        }
+        if (status) {
+            status_writer->write(record.position);
+            status_written++;
+        } else {
+            command_writer.write(record.position);
+            commands_written++;
+        }
+        lateness.record(latency::now_ns() - deadline_ns);
+    }
+
+    std::cout << "Replayed " << commands_written << " commands";
+    if (status_writer != NULL) {
+        std::cout << " and " << status_written << " status samples";
+    }
+    std::cout << " in " << (latency::now_ns() - replay_start_ns) / 1e9 << " s" << std::endl;
+    lateness.print(std::cout, "Write lateness (us):", 1000.0);
+}
+
+void run_replay_application(const application::ApplicationArguments& arguments)
+{
+    std::vector<trace::Record> records;
+    if (arguments.trace_file.empty()) {
+        throw std::invalid_argument("no trace to replay (--trace)");
+    }
+    if (!trace::load(arguments.trace_file, records)) {
+        throw std::runtime_error("cannot read trace " + arguments.trace_file);
+    }
+    std::cout << "Loaded " << records.size() << " records from "
+              << arguments.trace_file << std::endl;
+
+    // DDS objects behave like shared pointers or value types
+    // (see https://community.rti.com/best-practices/use-modern-c-types-correctly)
+
+    // When using user-generated types, you must register the type with RTI
+    // Connext DDS before creating the participants and the rest of the entities
+    // in your system
+    rti::domain::register_type<actuation::SteeringDesired>("rti::actuation::SteeringDesired");
+    rti::domain::register_type<actuation::SteeringActual>("rti::actuation::SteeringActual");
+
+    // Create the participant, changing the domain id from the one in the
+    // configuration
+    rti::domain::DomainParticipantConfigParams params(arguments.domain_id);
+
+    // The replay stands in for a controller
+    auto default_provider = dds::core::QosProvider::Default();
+    dds::domain::DomainParticipant participant =
+    default_provider->create_participant_from_config(
+        "SteeringParticipantLib::SteeringController",
+        params);
+    transport::configure(participant, arguments.transport);
+    transport::configure_discovery(participant, arguments.peers, arguments.fast_discovery);
+
+    // Lookup the DataWriter from the configuration
+    dds::pub::DataWriter<actuation::SteeringDesired> command_writer =
+    rti::pub::find_datawriter_by_name<dds::pub::DataWriter<actuation::SteeringDesired>>(
+        participant,
+        "outputs::Steering_writer");
+
+    // Set strength of the DataWriter
+    auto command_writer_qos = command_writer.qos();
+    command_writer_qos << dds::core::policy::OwnershipStrength(arguments.strength);
+    command_writer.qos(command_writer_qos);
+
+    // With --status, the replay also stands in for the actuator's status,
+    // through a participant of the actuator's configuration
+    dds::domain::DomainParticipant status_participant(dds::core::null);
+    std::unique_ptr<transport::SampleWriter<actuation::SteeringActual>> status_writer;
+    if (arguments.replay_status) {
+        status_participant = default_provider->create_participant_from_config(
+            "SteeringParticipantLib::SteeringColumn",
+            params);
+        transport::configure(status_participant, arguments.transport);
+        transport::configure_discovery(status_participant, arguments.peers, arguments.fast_discovery);
+        // Only its status writer is used
+        rti::sub::find_datareader_by_name<dds::sub::DataReader<actuation::SteeringDesired>>(
+            status_participant,
+            "inputs::Steering_reader").close();
+        status_writer.reset(new transport::SampleWriter<actuation::SteeringActual>(
+            rti::pub::find_datawriter_by_name<dds::pub::DataWriter<actuation::SteeringActual>>(
+                status_participant,
+                "outputs::Steering_writer")));
+    }
+
+    // Enable the participant and underlying entities recursively
+    participant.enable();
+    if (status_writer) {
+        status_participant.enable();
+    }
+
+    // Do not start replaying before the actuator (or, with --status, a
+    // display) is listening
+    std::cout << "Waiting for the actuator..." << std::endl;
+    while (!application::shutdown_requested
+            && command_writer.publication_matched_status().current_count() == 0
+            && (!status_writer
+                || status_writer->writer().publication_matched_status().current_count() == 0)) {
+        rti::util::sleep(dds::core::Duration::from_millisecs(100));
+    }
+
+    std::cout << "Replaying at " << arguments.replay_speed << "x speed..." << std::endl;
+    transport::SampleWriter<actuation::SteeringDesired> sample_writer(command_writer);
+    replay_trace(
+        sample_writer,
+        status_writer.get(),
+        records,
+        arguments.replay_speed > 0.0 ? arguments.replay_speed : 1.0);
+}
+
+int main(int argc, char *argv[])
+{
+
+    using namespace application;
+
+    // Parse arguments and handle control-C
+    auto arguments = parse_arguments(argc, argv);
+    if (arguments.parse_result == ParseReturn::exit) {
+        return EXIT_SUCCESS;
+    } else if (arguments.parse_result == ParseReturn::failure) {
+        return EXIT_FAILURE;
+    }
+    setup_signal_handlers();
+
+    // Sets Connext verbosity to help debugging
+    rti::config::Logger::instance().verbosity(arguments.verbosity);
+
+    try {
+        run_replay_application(arguments);
+    } catch (const std::exception& ex) {
+        // This will catch DDS exceptions
+        std::cerr << "Exception in run_replay_application(): " << ex.what()
+        << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Releases the memory used by the participant factory.  Optional at
+    // application exit
+    dds::domain::DomainParticipant::finalize_participant_factory();
+
+    return EXIT_SUCCESS;
+}
@@ -14,24 +14,93 @@
 #define APPLICATION_HPP
 
 #include <iostream>
+#include <atomic>
+#include <string>
 #include <csignal>
+#include <cstdio>   // for sscanf()
+#include <cstdlib>  // for std::_Exit()
+#include <thread>
+#include <vector>
+#include <pthread.h>  // for pthread_sigmask()
 #include <dds/core/ddscore.hpp>
 
+#include "netsim.hpp"  // for the simulated link profile
+
 namespace application {
 
     // Catch control-C and tell application to shut down
-    bool shutdown_requested = false;
+    std::atomic<bool> shutdown_requested(false);
+
+    // Triggered on shutdown. Attach it to every WaitSet, so that a
+    // dispatch() returns as soon as the shutdown is requested instead of
+    // at its timeout.
+    inline dds::core::cond::GuardCondition& shutdown_condition()
+    {
+        static dds::core::cond::GuardCondition condition;
+        return condition;
+    }
+
+    // Runs the handlers of the active conditions of a WaitSet, as
+    // WaitSet::dispatch() does, but collects the active conditions into a
+    // sequence allocated once, up front, rather than into a new one on
+    // every wake-up
+    class Dispatcher {
+    public:
+        // 'max_conditions': the conditions attached, or more
+        Dispatcher(dds::core::cond::WaitSet& waitset, size_t max_conditions)
+            : waitset_(waitset)
+        {
+            active_conditions_.reserve(max_conditions);
+        }
+
+        void dispatch(const dds::core::Duration& timeout)
+        {
+            waitset_.wait(active_conditions_, timeout);
+            for (size_t i = 0; i < active_conditions_.size(); i++) {
+                active_conditions_[i].dispatch();
+            }
+        }
+
+    private:
+        dds::core::cond::WaitSet& waitset_;
+        dds::core::cond::WaitSet::ConditionSeq active_conditions_;
+    };
 
     inline void stop_handler(int)
     {
         shutdown_requested = true;
         std::cout << "preparing to shut down..." << std::endl;
+        shutdown_condition().trigger_value(true);
     }
 
+    // Call first in main(): SIGINT and SIGTERM are blocked in this thread
+    // and in all the threads it creates later (including the middleware's),
+    // and handled by a dedicated thread, where it is safe to trigger the
+    // shutdown condition. A second signal (e.g. during a hung shutdown)
+    // exits immediately.
     inline void setup_signal_handlers()
     {
-        signal(SIGINT, stop_handler);
-        signal(SIGTERM, stop_handler);
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+        shutdown_condition();
+        std::thread([signals]() {
+            int signal_number = 0;
+            for (int received = 0; ; ) {
+                if (sigwait(&signals, &signal_number) != 0) {
+                    continue;
+                }
+                if (received++ == 0) {
+                    stop_handler(signal_number);
+                } else {
+                    std::cout << "forced shutdown" << std::endl;
+                    std::_Exit(EXIT_FAILURE);
+                }
+            }
+        }).detach();
     }
 
     enum class ParseReturn {
@@ -40,11 +109,61 @@ namespace application {
         exit
     };
 
+    // Builtin transports to use, overriding the participant configuration
+    enum class Transport {
+        configured,
+        shmem,
+        udpv4
+    };
+
     struct ApplicationArguments {
         ParseReturn parse_result;
         unsigned int domain_id;
         unsigned int strength;
         rti::config::Verbosity verbosity;
+        unsigned int benchmark_samples = 0;
+        unsigned int warmup_samples = 100;
+        unsigned int rate = 1;
+        bool latest_only = false;
+        float deadband = 0.0f;
+        unsigned int keepalive_ms = 1000;
+        Transport transport = Transport::configured;
+        unsigned int frame_rate = 10;
+        int priority = 0;
+        int cpu = -1;
+        bool lock_memory = false;
+        std::string metrics_file;
+        unsigned int metrics_period_ms = 1000;
+        unsigned int model_rate = 0;
+        float slew_rate = 360.0f;
+        float max_acceleration = 1440.0f;
+        std::string trace_file;
+        double replay_speed = 1.0;
+        std::string scenario_file;
+        unsigned int writers = 0;
+        unsigned int duration_s = 0;
+        unsigned int lease_ms = 0;
+        unsigned int deadline_ms = 0;
+        unsigned int vehicles = 0;
+        unsigned int workers = 1;
+        std::string peers;
+        bool fast_discovery = false;
+        unsigned int batch_samples = 0;
+        unsigned int batch_window_us = 0;
+        bool async_publish = false;
+        unsigned int flow_period_us = 0;
+        unsigned int stream_seconds = 0;
+        unsigned int watchdog_us = 0;
+        unsigned int min_separation_ms = 0;
+        float min_change = 0.0f;
+        unsigned int max_age_us = 0;
+        bool closed_loop = false;
+        float kp = 0.5f;
+        float ki = 1.0f;
+        float kd = 0.0f;
+        netsim::LinkProfile link;
+        unsigned int crash_after_ms = 0;
+        bool replay_status = false;
 
         ApplicationArguments(
             ParseReturn parse_result_param,
@@ -89,6 +208,49 @@ namespace application {
         unsigned int domain_id = 0;
         unsigned int strength = 0;
         rti::config::Verbosity verbosity(rti::config::Verbosity::EXCEPTION);
+        unsigned int benchmark_samples = 0;
+        unsigned int warmup_samples = 100;
+        unsigned int rate = 1;
+        bool latest_only = false;
+        float deadband = 0.0f;
+        unsigned int keepalive_ms = 1000;
+        Transport transport = Transport::configured;
+        unsigned int frame_rate = 10;
+        int priority = 0;
+        int cpu = -1;
+        bool lock_memory = false;
+        std::string metrics_file;
+        unsigned int metrics_period_ms = 1000;
+        unsigned int model_rate = 0;
+        float slew_rate = 360.0f;
+        float max_acceleration = 1440.0f;
+        std::string trace_file;
+        double replay_speed = 1.0;
+        std::string scenario_file;
+        unsigned int writers = 0;
+        unsigned int duration_s = 0;
+        unsigned int lease_ms = 0;
+        unsigned int deadline_ms = 0;
+        unsigned int vehicles = 0;
+        unsigned int workers = 1;
+        std::string peers;
+        bool fast_discovery = false;
+        unsigned int batch_samples = 0;
+        unsigned int batch_window_us = 0;
+        bool async_publish = false;
+        unsigned int flow_period_us = 0;
+        unsigned int stream_seconds = 0;
+        unsigned int watchdog_us = 0;
+        unsigned int min_separation_ms = 0;
+        float min_change = 0.0f;
+        unsigned int max_age_us = 0;
+        bool closed_loop = false;
+        float kp = 0.5f;
+        float ki = 1.0f;
+        float kd = 0.0f;
+        netsim::LinkProfile link;
+        unsigned int crash_after_ms = 0;
+        bool replay_status = false;
 
         while (arg_processing < argc) {
             if ((argc > arg_processing + 1)
@@ -106,6 +268,192 @@ namespace application {
             || strcmp(argv[arg_processing], "--verbosity") == 0)) {
                 set_verbosity(verbosity, atoi(argv[arg_processing + 1]));
                 arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && (strcmp(argv[arg_processing], "-b") == 0
+            || strcmp(argv[arg_processing], "--benchmark") == 0)) {
+                benchmark_samples = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && (strcmp(argv[arg_processing], "-w") == 0
+            || strcmp(argv[arg_processing], "--warmup") == 0)) {
+                warmup_samples = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && (strcmp(argv[arg_processing], "-r") == 0
+            || strcmp(argv[arg_processing], "--rate") == 0)) {
+                rate = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if (strcmp(argv[arg_processing], "-l") == 0
+            || strcmp(argv[arg_processing], "--latest-only") == 0) {
+                latest_only = true;
+                arg_processing += 1;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--deadband") == 0) {
+                deadband = static_cast<float>(atof(argv[arg_processing + 1]));
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--keepalive") == 0) {
+                keepalive_ms = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && (strcmp(argv[arg_processing], "-t") == 0
+            || strcmp(argv[arg_processing], "--transport") == 0)) {
+                if (strcmp(argv[arg_processing + 1], "shmem") == 0) {
+                    transport = Transport::shmem;
+                } else if (strcmp(argv[arg_processing + 1], "udpv4") == 0) {
+                    transport = Transport::udpv4;
+                } else {
+                    std::cout << "Bad transport." << std::endl;
+                    show_usage = true;
+                    parse_result = ParseReturn::failure;
+                    break;
+                }
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && (strcmp(argv[arg_processing], "-f") == 0
+            || strcmp(argv[arg_processing], "--frame-rate") == 0)) {
+                frame_rate = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && (strcmp(argv[arg_processing], "-p") == 0
+            || strcmp(argv[arg_processing], "--priority") == 0)) {
+                priority = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && (strcmp(argv[arg_processing], "-c") == 0
+            || strcmp(argv[arg_processing], "--cpu") == 0)) {
+                cpu = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if (strcmp(argv[arg_processing], "-m") == 0
+            || strcmp(argv[arg_processing], "--mlock") == 0) {
+                lock_memory = true;
+                arg_processing += 1;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--metrics-file") == 0) {
+                metrics_file = argv[arg_processing + 1];
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--metrics-period") == 0) {
+                metrics_period_ms = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--model-rate") == 0) {
+                model_rate = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--slew-rate") == 0) {
+                slew_rate = static_cast<float>(atof(argv[arg_processing + 1]));
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--max-accel") == 0) {
+                max_acceleration = static_cast<float>(atof(argv[arg_processing + 1]));
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--trace") == 0) {
+                trace_file = argv[arg_processing + 1];
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--speed") == 0) {
+                replay_speed = atof(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--scenario") == 0) {
+                scenario_file = argv[arg_processing + 1];
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--writers") == 0) {
+                writers = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--duration") == 0) {
+                duration_s = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--liveliness-lease") == 0) {
+                lease_ms = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--deadline") == 0) {
+                deadline_ms = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--vehicles") == 0) {
+                vehicles = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--workers") == 0) {
+                workers = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--peers") == 0) {
+                peers = argv[arg_processing + 1];
+                arg_processing += 2;
+            } else if (strcmp(argv[arg_processing], "--fast-discovery") == 0) {
+                fast_discovery = true;
+                arg_processing += 1;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--batch") == 0) {
+                batch_samples = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--batch-window") == 0) {
+                batch_window_us = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if (strcmp(argv[arg_processing], "--async") == 0) {
+                async_publish = true;
+                arg_processing += 1;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--flow-period") == 0) {
+                flow_period_us = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--stream") == 0) {
+                stream_seconds = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--watchdog") == 0) {
+                watchdog_us = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--min-separation") == 0) {
+                min_separation_ms = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--min-change") == 0) {
+                min_change = static_cast<float>(atof(argv[arg_processing + 1]));
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--max-age") == 0) {
+                max_age_us = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if (strcmp(argv[arg_processing], "--closed-loop") == 0) {
+                closed_loop = true;
+                arg_processing += 1;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--gains") == 0) {
+                if (sscanf(argv[arg_processing + 1], "%f,%f,%f", &kp, &ki, &kd) != 3) {
+                    std::cout << "Bad gains." << std::endl;
+                    show_usage = true;
+                    parse_result = ParseReturn::failure;
+                    break;
+                }
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--link") == 0) {
+                if (!netsim::parse_profile(argv[arg_processing + 1], link)) {
+                    std::cout << "Bad link profile." << std::endl;
+                    show_usage = true;
+                    parse_result = ParseReturn::failure;
+                    break;
+                }
+                arg_processing += 2;
+            } else if ((argc > arg_processing + 1)
+            && strcmp(argv[arg_processing], "--crash-after") == 0) {
+                crash_after_ms = atoi(argv[arg_processing + 1]);
+                arg_processing += 2;
+            } else if (strcmp(argv[arg_processing], "--status") == 0) {
+                replay_status = true;
+                arg_processing += 1;
             } else if (strcmp(argv[arg_processing], "-h") == 0
             || strcmp(argv[arg_processing], "--help") == 0) {
                 std::cout << "Example application." << std::endl;
@@ -128,11 +476,206 @@ namespace application {
             "                               Default: 0\n"
             "    -v, --verbosity    <int>   How much debugging output to show.\n"\
             "                               Range: 0-3 \n"
-            "                               Default: 1"
+            "                               (events logged: 0 errors, 1-2 up to\n"
+            "                               info, 3 all)\n"
+            "                               Default: 1\n"
+            "    -b, --benchmark    <int>   Controller only: measure the round-trip\n"
+            "                               latency to the actuator over <int>\n"
+            "                               samples instead of writing the ramp.\n"
+            "                               Default: 0 (off)\n"
+            "    -w, --warmup       <int>   Benchmark samples to discard before\n"
+            "                               measuring.\n"
+            "                               Default: 100\n"
+            "    -r, --rate         <int>   Controller only: commands written per\n"
+            "                               second (Hz).\n"
+            "                               Default: 1\n"
+            "    -l, --latest-only          Actuator only: apply just the newest\n"
+            "                               command of each batch received.\n"
+            "        --deadband     <float> Actuator only: do not republish the\n"
+            "                               position while it stays within\n"
+            "                               <float> degrees of the last one sent.\n"
+            "                               Default: 0 (publish every change)\n"
+            "        --keepalive    <int>   Actuator only: with a deadband,\n"
+            "                               republish the position at least every\n"
+            "                               <int> milliseconds (0: never).\n"
+            "                               Default: 1000\n"
+            "    -t, --transport    <name>  Builtin transport to use instead of\n"
+            "                               the configured ones: shmem (apps on\n"
+            "                               the same host only) or udpv4.\n"
+            "                               Default: as configured\n"
+            "    -f, --frame-rate   <int>   Display only: dashboard refreshes per\n"
+            "                               second.\n"
+            "                               Default: 10\n"
+            "    -p, --priority     <int>   Actuator only: run the control loop\n"
+            "                               with this SCHED_FIFO priority (1-99).\n"
+            "                               Default: 0 (normal scheduling)\n"
+            "    -c, --cpu          <int>   Actuator only: pin the control loop to\n"
+            "                               this CPU.\n"
+            "                               Default: -1 (any CPU)\n"
+            "    -m, --mlock                Actuator only: lock and pre-fault\n"
+            "                               memory before starting.\n"
+            "        --metrics-file <path>  Periodically write the metrics to this\n"
+            "                               file, in Prometheus text format.\n"
+            "                               Default: none\n"
+            "        --metrics-period <int> Milliseconds between metrics exports.\n"
+            "                               Default: 1000\n"
+            "        --model-rate   <int>   Actuator only: simulate the column\n"
+            "                               dynamics, publishing the position at\n"
+            "                               this rate (Hz) instead of echoing\n"
+            "                               each command. The model thread runs\n"
+            "                               one --priority below the control loop,\n"
+            "                               on the CPU after its --cpu.\n"
+            "                               Default: 0 (echo)\n"
+            "        --slew-rate    <float> Actuator model: maximum speed, in\n"
+            "                               degrees per second.\n"
+            "                               Default: 360\n"
+            "        --max-accel    <float> Actuator model: maximum acceleration,\n"
+            "                               in degrees per second squared.\n"
+            "                               Default: 1440\n"
+            "        --trace        <path>  Controller, actuator: record the\n"
+            "                               steering samples to this binary trace.\n"
+            "                               Replay: the trace to replay.\n"
+            "                               Default: none\n"
+            "        --speed        <float> Replay only: replay speed factor\n"
+            "                               (2 replays twice as fast).\n"
+            "                               Default: 1\n"
+            "        --scenario     <path>  Load generator only: the controller\n"
+            "                               writers to run, with their strength,\n"
+            "                               rate and kill/revive schedule.\n"
+            "                               Default: none\n"
+            "        --writers      <int>   Load generator only: without a scenario,\n"
+            "                               run <int> writers with increasing\n"
+            "                               strengths and kill them in turn.\n"
+            "                               Default: 0\n"
+            "        --duration     <int>   Load generator only: seconds to run.\n"
+            "                               Default: 0 (until the schedule ends)\n"
+            "        --liveliness-lease <int> Controller, actuator: liveliness lease\n"
+            "                               duration in milliseconds.\n"
+            "                               Default: 0 (as configured)\n"
+            "        --deadline     <int>   Controller, actuator: deadline period\n"
+            "                               in milliseconds.\n"
+            "                               Default: 0 (as configured)\n"
+            "        --vehicles     <int>   Controller, actuator, display: serve a\n"
+            "                               fleet of <int> vehicles, vehicle <n>\n"
+            "                               in the partition \"vehicle/<n>\".\n"
+            "                               Default: 0 (one, as configured)\n"
+            "        --workers      <int>   Actuator only: control loop threads\n"
+            "                               sharing the vehicles of a fleet.\n"
+            "                               Default: 1\n"
+            "        --peers        <list>  Discover only these comma-separated\n"
+            "                               peers (e.g. shmem://,192.168.1.10)\n"
+            "                               instead of the configured ones.\n"
+            "                               Default: as configured\n"
+            "        --fast-discovery       Announce the app more often at startup,\n"
+            "                               to discover the other apps sooner.\n"
+            "        --batch        <int>   Controller only: send the commands in\n"
+            "                               batches of up to <int> samples.\n"
+            "                               Default: 0 (no batching)\n"
+            "        --batch-window <int>   Controller only: send a batch at most\n"
+            "                               <int> microseconds after its first\n"
+            "                               sample, full or not.\n"
+            "                               Default: 0 (no batching)\n"
+            "        --async                Controller only: send the commands from\n"
+            "                               a flow controller thread instead of\n"
+            "                               the writing thread.\n"
+            "        --flow-period  <int>   With --async: send at most one packet\n"
+            "                               (e.g. one batch) every <int>\n"
+            "                               microseconds.\n"
+            "                               Default: 0 (send as soon as written)\n"
+            "        --stream       <int>   Controller only: stream stamped commands\n"
+            "                               at --rate for <int> seconds and report\n"
+            "                               the CPU time and packets per sample\n"
+            "                               and the round-trip latency.\n"
+            "                               Default: 0 (off)\n"
+            "        --watchdog     <int>   Actuator only: steer to neutral when no\n"
+            "                               command arrives for <int> microseconds,\n"
+            "                               whatever the QoS and dispatch timing.\n"
+            "                               Default: 0 (off)\n"
+            "        --min-separation <int> Display only: receive at most one status\n"
+            "                               every <int> milliseconds (time-based\n"
+            "                               filter).\n"
+            "                               Default: 0 (every status)\n"
+            "        --min-change   <float> Display only: receive a status only when\n"
+            "                               the position moved by <float> degrees\n"
+            "                               since the last one received (filtered\n"
+            "                               by the actuator).\n"
+            "                               Default: 0 (every status)\n"
+            "        --max-age      <int>   Actuator only: drop the commands older\n"
+            "                               than <int> microseconds, from their\n"
+            "                               source timestamp to their reception\n"
+            "                               (the hosts' clocks must be in sync).\n"
+            "                               Default: 0 (apply any command)\n"
+            "        --closed-loop          Controller only: track a reference\n"
+            "                               trajectory from the actual positions\n"
+            "                               of the actuator, instead of writing\n"
+            "                               the open-loop ramp.\n"
+            "        --gains <kp,ki,kd>     Controller only: the gains of the\n"
+            "                               closed loop (ki per second, kd in\n"
+            "                               seconds).\n"
+            "                               Default: 0.5,1,0\n"
+            "        --link <loss,delay,jitter,reorder>\n"
+            "                               Write through a simulated link: lose\n"
+            "                               <loss>% of the samples, delay them by\n"
+            "                               <delay> +/- <jitter> microseconds and\n"
+            "                               hold back <reorder>% of them (the\n"
+            "                               commands of a controller, the status\n"
+            "                               of an actuator).\n"
+            "                               Default: 0,0,0,0 (off)\n"
+            "        --crash-after  <int>   Controller only: crash (SIGKILL) after\n"
+            "                               running for <int> milliseconds.\n"
+            "                               Default: 0 (never)\n"
+            "        --status               Replay only: also republish the status\n"
+            "                               written by the actuator in the trace\n"
+            "                               (in place of an actuator, e.g. for\n"
+            "                               the displays)."
             << std::endl;
         }
 
-        return ApplicationArguments(parse_result, domain_id, strength, verbosity);
+        ApplicationArguments arguments(parse_result, domain_id, strength, verbosity);
+        arguments.benchmark_samples = benchmark_samples;
+        arguments.warmup_samples = warmup_samples;
+        arguments.rate = rate;
+        arguments.latest_only = latest_only;
+        arguments.deadband = deadband;
+        arguments.keepalive_ms = keepalive_ms;
+        arguments.transport = transport;
+        arguments.frame_rate = frame_rate;
+        arguments.priority = priority;
+        arguments.cpu = cpu;
+        arguments.lock_memory = lock_memory;
+        arguments.metrics_file = metrics_file;
+        arguments.metrics_period_ms = metrics_period_ms;
+        arguments.model_rate = model_rate;
+        arguments.slew_rate = slew_rate;
+        arguments.max_acceleration = max_acceleration;
+        arguments.trace_file = trace_file;
+        arguments.replay_speed = replay_speed;
+        arguments.scenario_file = scenario_file;
+        arguments.writers = writers;
+        arguments.duration_s = duration_s;
+        arguments.lease_ms = lease_ms;
+        arguments.deadline_ms = deadline_ms;
+        arguments.vehicles = vehicles;
+        arguments.workers = workers;
+        arguments.peers = peers;
+        arguments.fast_discovery = fast_discovery;
+        arguments.batch_samples = batch_samples;
+        arguments.batch_window_us = batch_window_us;
+        arguments.async_publish = async_publish;
+        arguments.flow_period_us = flow_period_us;
+        arguments.stream_seconds = stream_seconds;
+        arguments.watchdog_us = watchdog_us;
+        arguments.min_separation_ms = min_separation_ms;
+        arguments.min_change = min_change;
+        arguments.max_age_us = max_age_us;
+        arguments.closed_loop = closed_loop;
+        arguments.kp = kp;
+        arguments.ki = ki;
+        arguments.kd = kd;
+        arguments.link = link;
+        arguments.crash_after_ms = crash_after_ms;
+        arguments.replay_status = replay_status;
+        return arguments;
     }
 
 }  // namespace application
@@ -0,0 +1,234 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+// Checks that the steady-state cycles of the three apps make no heap
+// allocation: once warmed up, a controller write, a closed-loop controller
+// cycle, an actuator dispatch (taking the commands and writing the status)
+// and a display dispatch must not call operator new. Built from the
+// sources of the apps; fails if any cycle allocates, or if a cycle did
+// not process a sample (so that it checked nothing).
+#define STEERING_NO_MAIN
+#include "SteeringController.cxx"
+#include "SteeringColumn.cxx"
+#include "SteeringDisplay.cxx"
+#include "bench/bench.hpp"
+#include "bench/allocations.hpp"
+
+const unsigned int WARMUP_COUNT = 1000;
+const unsigned int CYCLE_COUNT = 10000;
+const unsigned int PRINT_PERIOD = 1000;  // cycles between the commands logged
+
+// The allocations of one part of the cycle, after the warm-up
+struct AllocationCount {
+    AllocationCount(const char *name) : name(name), total(0), cycles(0), idle(0) {}
+
+    // Counts the allocations of a cycle, and whether it processed a sample
+    void record(uint64_t allocations, bool processed)
+    {
+        if (allocations > 0) {
+            total += allocations;
+            cycles++;
+        }
+        if (!processed) {
+            idle++;
+        }
+    }
+
+    const char *name;
+    uint64_t total;
+    uint64_t cycles;  // the cycles that allocated
+    uint64_t idle;    // the cycles that processed no sample
+};
+
+bool run_allocation_check()
+{
+    rti::domain::register_type<actuation::SteeringDesired>("rti::actuation::SteeringDesired");
+    rti::domain::register_type<actuation::SteeringActual>("rti::actuation::SteeringActual");
+
+    application::ApplicationArguments arguments(
+        application::ParseReturn::ok,
+        bench::DOMAIN_ID,
+        0,
+        rti::config::Verbosity::EXCEPTION);
+    eventlog::Session log_session(arguments.verbosity);
+
+    dds::domain::DomainParticipant controller =
+        bench::create_participant("SteeringParticipantLib::SteeringController");
+    dds::domain::DomainParticipant column_participant =
+        bench::create_participant("SteeringParticipantLib::SteeringColumn");
+    dds::domain::DomainParticipant display =
+        bench::create_participant("SteeringParticipantLib::SteeringDisplay");
+
+    // The controller writes open-loop commands, and closed-loop commands
+    // from the status it takes
+    dds::pub::DataWriter<actuation::SteeringDesired> command_writer =
+        rti::pub::find_datawriter_by_name<dds::pub::DataWriter<actuation::SteeringDesired>>(
+        controller,
+        "outputs::Steering_writer");
+    dds::sub::DataReader<actuation::SteeringActual> feedback_reader =
+        rti::sub::find_datareader_by_name<dds::sub::DataReader<actuation::SteeringActual>>(
+        controller,
+        "inputs::Steering_reader");
+    // Waits for the status, so that every closed-loop cycle has feedback
+    dds::sub::cond::ReadCondition feedback_condition(
+        feedback_reader,
+        dds::sub::status::DataState::any());
+    dds::core::cond::WaitSet feedback_waitset;
+    feedback_waitset += feedback_condition;
+    dds::core::cond::WaitSet::ConditionSeq feedback_conditions;
+    feedback_conditions.reserve(1);
+
+    // An echoing actuator, as run by default
+    ColumnMetrics column_metrics;
+    trace::Recorder recorder;
+    watchdog::Watchdog watchdog(0, 1);
+    Column column(
+        rti::sub::find_datareader_by_name<dds::sub::DataReader<actuation::SteeringDesired>>(
+            column_participant,
+            "inputs::Steering_reader"),
+        rti::pub::find_datawriter_by_name<dds::pub::DataWriter<actuation::SteeringActual>>(
+            column_participant,
+            "outputs::Steering_writer"),
+        arguments,
+        column_metrics,
+        recorder,
+        watchdog,
+        0);
+    dds::core::cond::WaitSet column_waitset;
+    application::Dispatcher column_dispatcher(column_waitset, column.attach(column_waitset));
+
+    // A display, handing the status to a (stand-in) render thread
+    dds::sub::DataReader<actuation::SteeringActual> status_reader =
+        rti::sub::find_datareader_by_name<dds::sub::DataReader<actuation::SteeringActual>>(
+        display,
+        "inputs::Steering_reader");
+    DisplayRing ring(1024);
+    DisplayMetrics display_metrics;
+    dds::sub::cond::ReadCondition read_condition(
+        status_reader,
+        dds::sub::status::DataState::any(),
+        [status_reader, &ring, &display_metrics]() {
+            process_data(status_reader, 0, ring, display_metrics);
+        });
+    dds::core::cond::WaitSet display_waitset;
+    display_waitset += read_condition;
+    application::Dispatcher display_dispatcher(display_waitset, 1);
+
+    controller.enable();
+    column_participant.enable();
+    display.enable();
+    if (!bench::wait_for_match(command_writer, status_reader)) {
+        throw std::runtime_error("the actuator or the display did not match");
+    }
+
+    metrics::ComponentMetrics controller_metrics("SteeringController");
+    std::vector<std::unique_ptr<CommandWriter>> sample_writers;
+    sample_writers.push_back(std::unique_ptr<CommandWriter>(new CommandWriter(command_writer)));
+    netsim::CrashSchedule crash_schedule(0);
+    ClosedLoop closed_loop(
+        *sample_writers.front(),
+        feedback_reader,
+        arguments,
+        controller_metrics,
+        recorder);
+    AllocationCount controller_write("controller write");
+    AllocationCount controller_cycle("closed-loop cycle");
+    AllocationCount column_dispatch("actuator dispatch");
+    AllocationCount display_dispatch("display dispatch");
+    DisplaySample display_sample;
+    for (unsigned int i = 0; i < WARMUP_COUNT + CYCLE_COUNT; i++) {
+        bool counting = (i >= WARMUP_COUNT);
+
+        // A cycle of the controller's write loop
+        uint64_t written = controller_metrics.samples_written.value();
+        uint64_t start_count = bench::thread_allocations();
+        write_commands(i, PRINT_PERIOD, sample_writers, controller_metrics, recorder, crash_schedule);
+        uint64_t allocations = bench::thread_allocations() - start_count;
+        if (counting) {
+            controller_write.record(
+                allocations,
+                controller_metrics.samples_written.value() > written);
+        }
+
+        // A cycle of the controller's closed loop, once the status of the
+        // previous cycle arrived
+        feedback_waitset.wait(feedback_conditions, dds::core::Duration(1));
+        uint64_t feedback = controller_metrics.samples_taken.value();
+        start_count = bench::thread_allocations();
+        closed_loop.cycle();
+        allocations = bench::thread_allocations() - start_count;
+        if (counting) {
+            controller_cycle.record(
+                allocations,
+                controller_metrics.samples_taken.value() > feedback);
+        }
+
+        // A cycle of the actuator's control loop
+        uint64_t commands = column_metrics.samples_taken.value();
+        start_count = bench::thread_allocations();
+        column_dispatcher.dispatch(dds::core::Duration(1));
+        column.keep_alive();
+        allocations = bench::thread_allocations() - start_count;
+        if (counting) {
+            column_dispatch.record(allocations, column_metrics.samples_taken.value() > commands);
+        }
+
+        // A cycle of the display's dispatch
+        uint64_t statuses = display_metrics.samples_taken.value();
+        start_count = bench::thread_allocations();
+        display_dispatcher.dispatch(dds::core::Duration(1));
+        allocations = bench::thread_allocations() - start_count;
+        if (counting) {
+            display_dispatch.record(allocations, display_metrics.samples_taken.value() > statuses);
+        }
+        while (ring.pop(display_sample)) {
+        }
+    }
+
+    bool passed = true;
+    const AllocationCount *counts[] = {
+        &controller_write,
+        &controller_cycle,
+        &column_dispatch,
+        &display_dispatch
+    };
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        std::cout << std::left << std::setw(20) << counts[i]->name << std::right
+                  << std::setw(8) << counts[i]->total << " allocations in "
+                  << counts[i]->cycles << " of " << CYCLE_COUNT << " cycles, "
+                  << counts[i]->idle << " idle" << std::endl;
+        if (counts[i]->total > 0 || counts[i]->idle > 0) {
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+int main()
+{
+    bool passed = false;
+    try {
+        passed = run_allocation_check();
+    } catch (const std::exception& ex) {
+        // This will catch DDS exceptions
+        std::cerr << "Exception in run_allocation_check(): " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    dds::domain::DomainParticipant::finalize_participant_factory();
+
+    if (!passed) {
+        std::cerr << "The steady state allocates, or a cycle processed nothing" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+// Microbenchmarks of the SteeringColumn's handlers, built from its sources
+#define STEERING_NO_MAIN
+#include "SteeringColumn.cxx"
+#include "bench/bench.hpp"
+
+const unsigned int WARMUP_COUNT = 1000;
+const unsigned int SAMPLE_COUNT = 10000;
+
+void run_column_bench(bench::Report& report)
+{
+    rti::domain::register_type<actuation::SteeringDesired>("rti::actuation::SteeringDesired");
+    rti::domain::register_type<actuation::SteeringActual>("rti::actuation::SteeringActual");
+
+    // A controller writes the commands that the actuator handles
+    dds::domain::DomainParticipant controller =
+        bench::create_participant("SteeringParticipantLib::SteeringController");
+    dds::domain::DomainParticipant column =
+        bench::create_participant("SteeringParticipantLib::SteeringColumn");
+    dds::pub::DataWriter<actuation::SteeringDesired> command_writer =
+        rti::pub::find_datawriter_by_name<dds::pub::DataWriter<actuation::SteeringDesired>>(
+        controller,
+        "outputs::Steering_writer");
+    dds::sub::DataReader<actuation::SteeringDesired> command_reader =
+        rti::sub::find_datareader_by_name<dds::sub::DataReader<actuation::SteeringDesired>>(
+        column,
+        "inputs::Steering_reader");
+    dds::pub::DataWriter<actuation::SteeringActual> status_writer =
+        rti::pub::find_datawriter_by_name<dds::pub::DataWriter<actuation::SteeringActual>>(
+        column,
+        "outputs::Steering_writer");
+
+    // An echoing actuator, as run by default
+    ColumnMetrics metrics;
+    trace::Recorder recorder;
+    watchdog::Watchdog watchdog(0, 1);
+    failover::ReactionTimer reaction;
+    StatusPublisher status_publisher(status_writer, 0.0f, 0, metrics, recorder);
+    SteeringActuator actuator(status_publisher, NULL);
+
+    controller.enable();
+    column.enable();
+    if (!bench::wait_for_match(command_writer, command_reader)) {
+        throw std::runtime_error("the command reader did not match");
+    }
+
+    // process_data(): take and apply one command
+    transport::SampleWriter<actuation::SteeringDesired> sample_writer(command_writer);
+    latency::Histogram histogram;
+    int64_t total_ns = 0;
+    for (unsigned int i = 0; i < WARMUP_COUNT + SAMPLE_COUNT; i++) {
+        sample_writer.write(static_cast<float>(i % 360) - 180.0f);
+        if (!bench::wait_for_samples(command_reader, 1)) {
+            throw std::runtime_error("a command was not received");
+        }
+
+        int64_t start_ns = latency::now_ns();
+        process_data(command_reader, actuator, false, 0, metrics, recorder, reaction, watchdog, 0);
+        int64_t duration_ns = latency::now_ns() - start_ns;
+        if (i >= WARMUP_COUNT) {
+            histogram.record(duration_ns);
+            total_ns += duration_ns;
+        }
+    }
+    report.add("column.process_data", histogram, SAMPLE_COUNT * 1e9 / total_ns);
+
+    // handle_status(): check the statuses of the command reader, as on a
+    // wake-up by its StatusCondition
+    histogram.reset();
+    total_ns = 0;
+    for (unsigned int i = 0; i < WARMUP_COUNT + SAMPLE_COUNT; i++) {
+        int64_t start_ns = latency::now_ns();
+        handle_status(command_reader, actuator, metrics, reaction);
+        int64_t duration_ns = latency::now_ns() - start_ns;
+        if (i >= WARMUP_COUNT) {
+            histogram.record(duration_ns);
+            total_ns += duration_ns;
+        }
+    }
+    report.add("column.handle_status", histogram, SAMPLE_COUNT * 1e9 / total_ns);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string results_file;
+    std::string commit;
+    if (!bench::parse_arguments(argc, argv, results_file, commit)) {
+        return EXIT_FAILURE;
+    }
+
+    bench::Report report("ColumnBench", commit);
+    try {
+        run_column_bench(report);
+    } catch (const std::exception& ex) {
+        // This will catch DDS exceptions
+        std::cerr << "Exception in run_column_bench(): " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!report.write(results_file)) {
+        std::cerr << "Cannot write " << results_file << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    dds::domain::DomainParticipant::finalize_participant_factory();
+
+    return EXIT_SUCCESS;
+}
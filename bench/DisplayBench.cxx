@@ -0,0 +1,98 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+// Microbenchmarks of the SteeringDisplay's handlers, built from its sources
+#define STEERING_NO_MAIN
+#include "SteeringDisplay.cxx"
+#include "bench/bench.hpp"
+
+const unsigned int WARMUP_COUNT = 1000;
+const unsigned int SAMPLE_COUNT = 10000;
+
+void run_display_bench(bench::Report& report)
+{
+    rti::domain::register_type<actuation::SteeringActual>("rti::actuation::SteeringActual");
+
+    // An actuator writes the status that the display takes
+    dds::domain::DomainParticipant column =
+        bench::create_participant("SteeringParticipantLib::SteeringColumn");
+    dds::domain::DomainParticipant display =
+        bench::create_participant("SteeringParticipantLib::SteeringDisplay");
+    dds::pub::DataWriter<actuation::SteeringActual> status_writer =
+        rti::pub::find_datawriter_by_name<dds::pub::DataWriter<actuation::SteeringActual>>(
+        column,
+        "outputs::Steering_writer");
+    dds::sub::DataReader<actuation::SteeringActual> status_reader =
+        rti::sub::find_datareader_by_name<dds::sub::DataReader<actuation::SteeringActual>>(
+        display,
+        "inputs::Steering_reader");
+
+    DisplayRing ring(1024);
+    DisplayMetrics metrics;
+
+    column.enable();
+    display.enable();
+    if (!bench::wait_for_match(status_writer, status_reader)) {
+        throw std::runtime_error("the status reader did not match");
+    }
+
+    // process_data(): take one status and hand it to the render thread
+    transport::SampleWriter<actuation::SteeringActual> sample_writer(status_writer);
+    latency::Histogram histogram;
+    int64_t total_ns = 0;
+    DisplaySample display_sample;
+    for (unsigned int i = 0; i < WARMUP_COUNT + SAMPLE_COUNT; i++) {
+        sample_writer.write(static_cast<float>(i % 360) - 180.0f);
+        if (!bench::wait_for_samples(status_reader, 1)) {
+            throw std::runtime_error("a status was not received");
+        }
+
+        int64_t start_ns = latency::now_ns();
+        process_data(status_reader, 0, ring, metrics);
+        int64_t duration_ns = latency::now_ns() - start_ns;
+        if (i >= WARMUP_COUNT) {
+            histogram.record(duration_ns);
+            total_ns += duration_ns;
+        }
+
+        // Stand in for the render thread
+        while (ring.pop(display_sample)) {
+        }
+    }
+    report.add("display.process_data", histogram, SAMPLE_COUNT * 1e9 / total_ns);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string results_file;
+    std::string commit;
+    if (!bench::parse_arguments(argc, argv, results_file, commit)) {
+        return EXIT_FAILURE;
+    }
+
+    bench::Report report("DisplayBench", commit);
+    try {
+        run_display_bench(report);
+    } catch (const std::exception& ex) {
+        // This will catch DDS exceptions
+        std::cerr << "Exception in run_display_bench(): " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!report.write(results_file)) {
+        std::cerr << "Cannot write " << results_file << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    dds::domain::DomainParticipant::finalize_participant_factory();
+
+    return EXIT_SUCCESS;
+}
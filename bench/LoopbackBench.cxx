@@ -0,0 +1,202 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+// End-to-end benchmark of a controller and a SteeringColumn in the same
+// process, over shared memory: the round-trip latency of single commands,
+// and the throughput of a stream of commands
+#define STEERING_NO_MAIN
+#include "SteeringColumn.cxx"
+#include "bench/bench.hpp"
+
+const unsigned int WARMUP_COUNT = 1000;
+const unsigned int SAMPLE_COUNT = 10000;
+const int64_t STREAM_DURATION_NS = 2000000000LL;
+// Commands in flight during the stream
+const unsigned int STREAM_WINDOW = 64;
+
+// Matches the echoed status samples against the outstanding commands.
+// Returns the number of round trips completed.
+unsigned int process_echoes(
+    dds::sub::DataReader<actuation::SteeringActual> reader,
+    latency::RoundTripTracker& tracker,
+    latency::Histogram& histogram)
+{
+    int64_t receive_ns = latency::now_ns();
+    unsigned int count = 0;
+
+    dds::sub::LoanedSamples<actuation::SteeringActual> samples = reader.take();
+    for (const auto& sample : samples) {
+        if (sample.info().valid()) {
+            int64_t round_trip_ns = tracker.match(sample.data().position(), receive_ns);
+            if (round_trip_ns >= 0) {
+                histogram.record(round_trip_ns);
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+void run_loopback_bench(bench::Report& report)
+{
+    rti::domain::register_type<actuation::SteeringDesired>("rti::actuation::SteeringDesired");
+    rti::domain::register_type<actuation::SteeringActual>("rti::actuation::SteeringActual");
+
+    dds::domain::DomainParticipant controller =
+        bench::create_participant("SteeringParticipantLib::SteeringController");
+    dds::domain::DomainParticipant column_participant =
+        bench::create_participant("SteeringParticipantLib::SteeringColumn");
+    dds::pub::DataWriter<actuation::SteeringDesired> command_writer =
+        rti::pub::find_datawriter_by_name<dds::pub::DataWriter<actuation::SteeringDesired>>(
+        controller,
+        "outputs::Steering_writer");
+    dds::sub::DataReader<actuation::SteeringActual> status_reader =
+        rti::sub::find_datareader_by_name<dds::sub::DataReader<actuation::SteeringActual>>(
+        controller,
+        "inputs::Steering_reader");
+
+    // The actuator, with its default (echo) arguments, runs its control
+    // loop on its own thread as in the app
+    application::ApplicationArguments arguments(
+        application::ParseReturn::ok,
+        bench::DOMAIN_ID,
+        0,
+        rti::config::Verbosity::EXCEPTION);
+    ColumnMetrics metrics;
+    trace::Recorder recorder;
+    watchdog::Watchdog watchdog(0, 1);
+    Column column(
+        rti::sub::find_datareader_by_name<dds::sub::DataReader<actuation::SteeringDesired>>(
+            column_participant,
+            "inputs::Steering_reader"),
+        rti::pub::find_datawriter_by_name<dds::pub::DataWriter<actuation::SteeringActual>>(
+            column_participant,
+            "outputs::Steering_writer"),
+        arguments,
+        metrics,
+        recorder,
+        watchdog,
+        0);
+
+    controller.enable();
+    column_participant.enable();
+
+    std::atomic<bool> done(false);
+    dds::core::cond::GuardCondition stop_condition;
+    std::thread control_thread([&column, &done, &stop_condition]() {
+        dds::core::cond::WaitSet waitset;
+        waitset += stop_condition;
+        column.attach(waitset);
+        while (!done) {
+            waitset.dispatch(dds::core::Duration(1));
+        }
+    });
+
+    latency::RoundTripTracker tracker;
+    latency::Histogram histogram;
+    dds::sub::cond::ReadCondition read_condition(
+        status_reader,
+        dds::sub::status::DataState::new_data());
+    dds::core::cond::WaitSet waitset;
+    waitset += read_condition;
+
+    transport::SampleWriter<actuation::SteeringDesired> sample_writer(command_writer);
+    std::string error;
+    if (!bench::wait_for_match(command_writer, status_reader)) {
+        error = "the actuator did not match";
+    }
+
+    // Round-trip latency: one command at a time
+    unsigned int samples_lost = 0;
+    int64_t start_ns = latency::now_ns();
+    for (unsigned int i = 0; error.empty() && i < WARMUP_COUNT + SAMPLE_COUNT; i++) {
+        if (i == WARMUP_COUNT) {
+            histogram.reset();
+            samples_lost = 0;
+            start_ns = latency::now_ns();
+        }
+        float position = tracker.stamp(latency::now_ns());
+        sample_writer.write(position);
+        if (waitset.wait(dds::core::Duration(1)).empty()
+                || process_echoes(status_reader, tracker, histogram) == 0) {
+            tracker.cancel(position);
+            samples_lost++;
+        }
+    }
+    if (error.empty()) {
+        report.add(
+            "loopback.round_trip",
+            histogram,
+            SAMPLE_COUNT * 1e9 / (latency::now_ns() - start_ns));
+        std::cout << "Round trips lost: " << samples_lost << std::endl;
+    }
+
+    // Throughput: keep a window of commands in flight
+    histogram.reset();
+    unsigned int samples_written = 0;
+    unsigned int samples_echoed = 0;
+    samples_lost = 0;
+    start_ns = latency::now_ns();
+    while (error.empty() && latency::now_ns() - start_ns < STREAM_DURATION_NS) {
+        while (samples_written - samples_echoed - samples_lost < STREAM_WINDOW) {
+            sample_writer.write(tracker.stamp(latency::now_ns()));
+            samples_written++;
+        }
+        if (waitset.wait(dds::core::Duration::from_millisecs(100)).empty()) {
+            // The echoes in flight were lost (e.g. replaced in a history):
+            // open the window again
+            samples_lost = samples_written - samples_echoed;
+            continue;
+        }
+        samples_echoed += process_echoes(status_reader, tracker, histogram);
+    }
+    if (error.empty()) {
+        report.add(
+            "loopback.stream",
+            histogram,
+            samples_echoed * 1e9 / (latency::now_ns() - start_ns));
+        std::cout << "Stream echoes lost: " << samples_lost << std::endl;
+    }
+
+    done = true;
+    stop_condition.trigger_value(true);
+    control_thread.join();
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string results_file;
+    std::string commit;
+    if (!bench::parse_arguments(argc, argv, results_file, commit)) {
+        return EXIT_FAILURE;
+    }
+
+    bench::Report report("LoopbackBench", commit);
+    try {
+        run_loopback_bench(report);
+    } catch (const std::exception& ex) {
+        // This will catch DDS exceptions
+        std::cerr << "Exception in run_loopback_bench(): " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!report.write(results_file)) {
+        std::cerr << "Cannot write " << results_file << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    dds::domain::DomainParticipant::finalize_participant_factory();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef ALLOCATIONS_HPP
+#define ALLOCATIONS_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new and delete of the program to count the
+// heap allocations of each thread. Include in one translation unit only
+// (the operators cannot be inline).
+
+namespace bench {
+
+    // Allocations made by the calling thread so far
+    inline uint64_t& thread_allocations()
+    {
+        static thread_local uint64_t count = 0;
+        return count;
+    }
+
+    inline void *counted_allocation(std::size_t size)
+    {
+        thread_allocations()++;
+        void *pointer = std::malloc(size == 0 ? 1 : size);
+        if (pointer == NULL) {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+
+}  // namespace bench
+
+void *operator new(std::size_t size)
+{
+    return bench::counted_allocation(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return bench::counted_allocation(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    bench::thread_allocations()++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    bench::thread_allocations()++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+#endif  // ALLOCATIONS_HPP
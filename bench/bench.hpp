@@ -0,0 +1,151 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <dds/domain/ddsdomain.hpp>
+#include <dds/pub/ddspub.hpp>
+#include <dds/sub/ddssub.hpp>
+#include <rti/util/util.hpp>  // for sleep()
+
+#include "application.hpp"  // for application::Transport
+#include "latency.hpp"      // for now_ns() and histograms
+#include "transport.hpp"    // for shared memory
+
+namespace bench {
+
+    // Domain of the benchmark participants, away from the apps' default one
+    // so that running apps do not interfere
+    const int DOMAIN_ID = 42;
+
+    // Collects the results of a benchmark suite, and writes them as JSON so
+    // that the runs on different commits can be compared
+    class Report {
+    public:
+        Report(const std::string& suite, const std::string& commit)
+            : suite_(suite), commit_(commit) {}
+
+        // Adds the distribution of the time per operation, in nanoseconds,
+        // and the operations per second of a benchmark
+        void add(
+            const std::string& name,
+            const latency::Histogram& ns_per_operation,
+            double operations_per_second)
+        {
+            Result result = { name, ns_per_operation, operations_per_second };
+            results_.push_back(result);
+            ns_per_operation.print(std::cout, name.c_str(), 1.0);
+        }
+
+        bool write(const std::string& path) const
+        {
+            std::ofstream out(path.c_str());
+            out << "{\n"
+                << "  \"suite\": \"" << suite_ << "\",\n"
+                << "  \"commit\": \"" << commit_ << "\",\n"
+                << "  \"unit\": \"ns\",\n"
+                << "  \"results\": [";
+            for (size_t i = 0; i < results_.size(); i++) {
+                const latency::Histogram& histogram = results_[i].ns_per_operation;
+                out << (i == 0 ? "\n" : ",\n")
+                    << "    {\"name\": \"" << results_[i].name << "\""
+                    << ", \"count\": " << histogram.count()
+                    << ", \"min\": " << histogram.min()
+                    << ", \"p50\": " << histogram.percentile(50.0)
+                    << ", \"p99\": " << histogram.percentile(99.0)
+                    << ", \"p99_9\": " << histogram.percentile(99.9)
+                    << ", \"max\": " << histogram.max()
+                    << ", \"per_second\": " << static_cast<uint64_t>(results_[i].per_second)
+                    << "}";
+            }
+            out << "\n  ]\n}\n";
+            return out.good();
+        }
+
+    private:
+        struct Result {
+            std::string name;
+            latency::Histogram ns_per_operation;
+            double per_second;
+        };
+
+        std::string suite_;
+        std::string commit_;
+        std::vector<Result> results_;
+    };
+
+    // Creates a participant of the SteeringParticipantLib configuration that
+    // exchanges data with the others of the process over shared memory only,
+    // so that the benchmarks need no network
+    inline dds::domain::DomainParticipant create_participant(const std::string& config)
+    {
+        rti::domain::DomainParticipantConfigParams params(DOMAIN_ID);
+        auto default_provider = dds::core::QosProvider::Default();
+        dds::domain::DomainParticipant participant =
+            default_provider->create_participant_from_config(config, params);
+        transport::configure(participant, application::Transport::shmem);
+        return participant;
+    }
+
+    // Waits until a DataWriter and a DataReader of the process are matched
+    template <typename W, typename R>
+    bool wait_for_match(W& writer, R& reader)
+    {
+        int64_t deadline_ns = latency::now_ns() + 10000000000LL;
+        while (writer.publication_matched_status().current_count() == 0
+                || reader.subscription_matched_status().current_count() == 0) {
+            if (latency::now_ns() > deadline_ns) {
+                return false;
+            }
+            rti::util::sleep(dds::core::Duration::from_millisecs(10));
+        }
+        return true;
+    }
+
+    // Waits until a DataReader holds 'count' samples, without reading them
+    template <typename R>
+    bool wait_for_samples(R& reader, int64_t count)
+    {
+        int64_t deadline_ns = latency::now_ns() + 1000000000LL;
+        while (reader.extensions().datareader_cache_status().sample_count() < count) {
+            if (latency::now_ns() > deadline_ns) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Parses the command line of a benchmark: <results.json> [commit]
+    inline bool parse_arguments(
+        int argc,
+        char *argv[],
+        std::string& results_file,
+        std::string& commit)
+    {
+        if (argc < 2 || argc > 3) {
+            std::cerr << "Usage: " << argv[0] << " <results.json> [commit]" << std::endl;
+            return false;
+        }
+        results_file = argv[1];
+        commit = argc > 2 ? argv[2] : "";
+        return true;
+    }
+
+}  // namespace bench
+
+#endif  // BENCH_HPP
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+import argparse
+import glob
+import json
+import os
+import sys
+
+# Compares the benchmark results of two runs (e.g. of two commits), and
+# flags the benchmarks whose median or p99 time per operation grew by more
+# than the threshold
+
+parser = argparse.ArgumentParser(description="Compare benchmark results")
+parser.add_argument("baseline", help="Directory of the baseline results")
+parser.add_argument("current", help="Directory of the results to check")
+parser.add_argument("--threshold", type=float, default=10.0,
+                    help="Regression threshold, in percent (default: 10)")
+args = parser.parse_args()
+
+def load(directory):
+    results = {}
+    for path in glob.glob(os.path.join(directory, "*.json")):
+        with open(path) as f:
+            report = json.load(f)
+        for result in report["results"]:
+            results[result["name"]] = result
+    return results
+
+baseline = load(args.baseline)
+current = load(args.current)
+
+regressions = 0
+print(f"{'benchmark':<24} {'p50':>10} {'change':>8} {'p99':>10} {'change':>8}")
+for name in sorted(current):
+    if name not in baseline:
+        print(f"{name:<24} (new)")
+        continue
+    line = f"{name:<24}"
+    for metric in ("p50", "p99"):
+        before = baseline[name][metric]
+        after = current[name][metric]
+        change = (after - before) * 100.0 / before if before > 0 else 0.0
+        regressed = change > args.threshold
+        regressions += regressed
+        line += f" {after:>10} {change:>+7.1f}%{'!' if regressed else ' '}"
+    print(line)
+
+if regressions > 0:
+    print(f"{regressions} regressions above {args.threshold}%")
+    sys.exit(1)
@@ -0,0 +1,111 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef CONTROL_HPP
+#define CONTROL_HPP
+
+#include <cmath>
+
+namespace control {
+
+    // Fixed-step trajectory-tracking PID kernel.
+    //
+    // The command is the reference (feedforward) plus the PID correction
+    // of the tracking error, limited to +/- 'limit'. The derivative acts on
+    // the measurement, so that steps of the reference do not kick the
+    // command, and the integral does not grow while the command is
+    // saturated (anti-windup). The correction is only updated by a new
+    // measurement, over the time elapsed since the previous one; in
+    // between, it is held. A step is plain arithmetic on the state of the
+    // kernel: no allocation, no lock.
+    class Pid {
+    public:
+        // 'dt': the fixed step, in seconds; 'ki' per second, 'kd' in seconds
+        Pid(float kp, float ki, float kd, float dt, float limit)
+            : kp_(kp),
+            ki_(ki),
+            kd_(kd),
+            dt_(dt),
+            limit_(limit),
+            integral_(0.0f),
+            correction_(0.0f),
+            last_measured_(0.0f),
+            elapsed_(0.0f),
+            started_(false) {}
+
+        // Returns the command for one step. 'fresh': 'measured' is a new
+        // measurement, taken since the previous step
+        float step(float reference, float measured, bool fresh)
+        {
+            elapsed_ += dt_;
+            if (!fresh) {
+                return limit(reference + correction_);
+            }
+
+            float error = reference - measured;
+            float derivative = started_ ? (last_measured_ - measured) / elapsed_ : 0.0f;
+            float integral = integral_ + error * elapsed_;
+            last_measured_ = measured;
+            elapsed_ = 0.0f;
+            started_ = true;
+
+            correction_ = kp_ * error + ki_ * integral + kd_ * derivative;
+            float command = reference + correction_;
+            if (command > -limit_ && command < limit_) {
+                integral_ = integral;
+            }
+            return limit(command);
+        }
+
+    private:
+        float limit(float command) const
+        {
+            if (command > limit_) {
+                return limit_;
+            } else if (command < -limit_) {
+                return -limit_;
+            }
+            return command;
+        }
+
+        float kp_;
+        float ki_;
+        float kd_;
+        float dt_;
+        float limit_;
+        float integral_;
+        float correction_;
+        float last_measured_;
+        float elapsed_;  // since the last measurement, in seconds
+        bool started_;
+    };
+
+    // Reference steering trajectory: a sine sweep of the position
+    class SineTrajectory {
+    public:
+        SineTrajectory(float amplitude, float period_s)
+            : amplitude_(amplitude), angular_frequency_(2.0 * M_PI / period_s) {}
+
+        // Position at 't_s' seconds from the start
+        float at(double t_s) const
+        {
+            return amplitude_ * static_cast<float>(std::sin(angular_frequency_ * t_s));
+        }
+
+    private:
+        float amplitude_;
+        double angular_frequency_;
+    };
+
+}  // namespace control
+
+#endif  // CONTROL_HPP
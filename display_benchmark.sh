@@ -0,0 +1,85 @@
+#!/bin/bash
+######################################################################
+# display_benchmark.sh
+# (C) Copyright 2020-2025 Real-Time Innovations, Inc.  All rights reserved.
+#
+# The use of this software is governed by the terms specified in the RTI
+# Labs License Agreement, available at https://www.rti.com/terms/RTILabs.
+#
+# By accessing, downloading, or otherwise using this software, you agree to
+# be bound by those terms.
+######################################################################
+#
+# Measures what the SteeringDisplays cost the SteeringColumn as their
+# number grows, without and with the filters of the displays.
+#
+# For each number of displays and filter, a controller drives the actuator
+# at RATE Hz for DURATION seconds while the displays subscribe to its
+# status over UDP. The actuator reports its CPU time on exit, and the UDP
+# datagrams sent by the host during the run are counted (all the apps run
+# on this host, so they include the commands).
+#
+# Usage:
+#     ./display_benchmark.sh <arch>
+# e.g.
+#     DISPLAYS="1 10 50" SEPARATION=100 CHANGE=1.0 ./display_benchmark.sh x64Linux4gcc7.3.0
+
+ARCH=$1
+DISPLAYS=${DISPLAYS:-"1 10 50"}
+RATE=${RATE:-1000}
+DURATION=${DURATION:-10}
+SEPARATION=${SEPARATION:-50}
+CHANGE=${CHANGE:-1.0}
+RESULTS=${RESULTS:-display_results}
+DATABUSHOME=${DATABUSHOME:-bus}
+
+if [ -z "$ARCH" ]; then
+    echo "Usage: $0 <arch>"
+    exit 1
+fi
+
+RUN="$DATABUSHOME/bin/run Steering"
+APPS=./objs/$ARCH
+mkdir -p $RESULTS
+
+FILTERS=(none separation change)
+OPTIONS=(
+    ""
+    "--min-separation $SEPARATION"
+    "--min-change $CHANGE"
+)
+
+udp_datagrams_sent() {
+    awk '/^Udp:/ { if (header) { print $5; exit } header = 1 }' /proc/net/snmp
+}
+
+for displays in $DISPLAYS; do
+    for i in ${!FILTERS[@]}; do
+        filter=${FILTERS[$i]}
+        log=$RESULTS/displays${displays}_$filter.txt
+        echo "$displays displays, $filter filter, $RATE Hz:"
+
+        $RUN $APPS/SteeringColumn --transport udpv4 > $log &
+        column=$!
+        for ((display = 0; display < displays; display++)); do
+            $RUN $APPS/SteeringDisplay --transport udpv4 ${OPTIONS[$i]} \
+                > /dev/null &
+        done
+        sleep 2  # discovery
+        $RUN $APPS/SteeringController --transport udpv4 --rate $RATE > /dev/null &
+        controller=$!
+
+        start_datagrams=$(udp_datagrams_sent)
+        sleep $DURATION
+        end_datagrams=$(udp_datagrams_sent)
+
+        pkill -INT -f "SteeringController --transport udpv4"
+        wait $controller
+        pkill -INT -f "SteeringDisplay --transport udpv4"
+        pkill -INT -f "SteeringColumn --transport udpv4"
+        wait
+        echo "UDP datagrams per second: $(( (end_datagrams - start_datagrams) / DURATION ))" \
+            | tee -a $log
+        grep -e "^Status samples written" -e "^Actuator CPU time" $log
+    done
+done
@@ -0,0 +1,330 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef EVENTLOG_HPP
+#define EVENTLOG_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+
+#include <dds/core/ddscore.hpp>
+#include <rti/config/Logger.hpp>  // for the verbosity
+
+#include "ring_buffer.hpp"  // for the record queue
+
+namespace eventlog {
+
+    // Severity of an event, from the most to the least severe
+    enum Severity {
+        error = 0,
+        warning = 1,
+        info = 2,
+        debug = 3
+    };
+
+    // The events the apps log
+    enum Event {
+        incompatible_qos,       // count: the last policy id
+        liveliness_lost,        // handle: the controller; count, total: active, inactive
+        controller_matched,     // handle: the controller; count: the matched ones
+        controller_unmatched,   // handle: the controller; count: the matched ones
+        deadline_missed,
+        steered_to_neutral,
+        watchdog_tripped,       // count: the channel (vehicle)
+        failover,               // handle: the new owner; value: the takeover time (ms)
+        safe_state,             // value: the time to the safe state (ms)
+        command_written,        // value: the position
+        status_dropped,         // count: the vehicle
+        command_stale,          // handle: the controller; value: the age (ms)
+        control_cycle           // count: the loop time (ns); value: the tracking error
+    };
+
+    inline Severity severity_of(Event event)
+    {
+        switch (event) {
+            case incompatible_qos:
+            return error;
+            case liveliness_lost:
+            case controller_unmatched:
+            case deadline_missed:
+            case steered_to_neutral:
+            case watchdog_tripped:
+            return warning;
+            case status_dropped:
+            case command_stale:
+            case control_cycle:
+            return debug;
+            default:
+            return info;
+        }
+    }
+
+    // Events up to the returned severity are logged at a --verbosity:
+    // 0 only errors, 1 and 2 (the default is 1) up to info, 3 everything
+    inline Severity threshold_of(rti::config::Verbosity verbosity)
+    {
+        if (verbosity == rti::config::Verbosity::SILENT) {
+            return error;
+        } else if (verbosity == rti::config::Verbosity::STATUS_ALL) {
+            return debug;
+        }
+        return info;
+    }
+
+    // An event as queued, formatted later by the logger thread
+    struct Record {
+        uint32_t event;  // Event
+        dds::core::InstanceHandle handle;
+        int64_t count;
+        int64_t total;
+        double value;
+    };
+
+    const size_t DEFAULT_CAPACITY = 4096;  // records
+
+    const int LABEL_WIDTH = 35;
+
+    // Logs the events of the apps without formatting or writing on the
+    // threads that report them (e.g. the control loops).
+    //
+    // record() queues a fixed-size binary record into a preallocated
+    // lock-free queue, from any number of threads, and never blocks: the
+    // records that do not fit are counted and dropped. A background thread
+    // formats and writes the queued records to the output.
+    class Logger {
+    public:
+        explicit Logger(size_t capacity = DEFAULT_CAPACITY, std::ostream& out = std::cout)
+            : records_(capacity),
+            out_(out),
+            threshold_(info),
+            dropped_(0),
+            reported_dropped_(0),
+            users_(0),
+            stop_(false) {}
+
+        ~Logger()
+        {
+            if (thread_.joinable()) {
+                stop_ = true;
+                thread_.join();
+            }
+        }
+
+        void threshold(Severity severity) { threshold_.store(severity, std::memory_order_relaxed); }
+
+        bool enabled(Event event) const
+        {
+            return severity_of(event) <= threshold_.load(std::memory_order_relaxed);
+        }
+
+        void record(
+            Event event,
+            const dds::core::InstanceHandle& handle,
+            int64_t count,
+            int64_t total,
+            double value)
+        {
+            if (!enabled(event)) {
+                return;
+            }
+            Record record;
+            record.event = event;
+            record.handle = handle;
+            record.count = count;
+            record.total = total;
+            record.value = value;
+            if (!records_.push(record)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+        // Starts the logger thread for a user (e.g. a component of the
+        // launcher), unless it is running
+        void start()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (users_++ == 0) {
+                stop_ = false;
+                thread_ = std::thread(&Logger::run, this);
+            }
+        }
+
+        // Writes the queued records and stops the logger thread, once its
+        // last user stopped
+        void stop()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (users_ == 0 || --users_ > 0) {
+                return;
+            }
+            stop_ = true;
+            thread_.join();
+        }
+
+    private:
+        void run()
+        {
+            while (!stop_) {
+                write_records();
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            write_records();
+        }
+
+        void write_records()
+        {
+            // Each record is formatted in the buffer of the logger and written
+            // as one string, so that neither its formatting flags nor a
+            // partial line mix with other output to the same stream (e.g. the
+            // dashboard of the display)
+            Record record;
+            bool written = false;
+            while (records_.pop(record)) {
+                line_.str(empty_);
+                format(record, line_);
+                out_ << line_.str();
+                written = true;
+            }
+            uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (dropped != reported_dropped_) {
+                line_.str(empty_);
+                line_ << "(" << dropped - reported_dropped_ << " log records dropped)\n";
+                out_ << line_.str();
+                reported_dropped_ = dropped;
+                written = true;
+            }
+            if (written) {
+                out_ << std::flush;
+            }
+        }
+
+        void format(const Record& record, std::ostream& line)
+        {
+            switch (record.event) {
+                case incompatible_qos:
+                line << std::left << std::setw(LABEL_WIDTH) << std::setfill(' ')
+                     << "Requested Incompatible QoS by controller: " << record.count;
+                break;
+                case liveliness_lost:
+                line << std::left << std::setw(LABEL_WIDTH) << std::setfill(' ')
+                     << "Liveliness changed for controller:" << record.handle
+                     << " (active " << record.count << ", inactive " << record.total << ")";
+                break;
+                case controller_matched:
+                line << std::left << std::setw(LABEL_WIDTH) << std::setfill(' ')
+                     << "Matched controller:" << record.handle
+                     << " (count " << record.count << ")";
+                break;
+                case controller_unmatched:
+                line << std::left << std::setw(LABEL_WIDTH) << std::setfill(' ')
+                     << "Unmatched controller:" << record.handle
+                     << " (count " << record.count << ")";
+                break;
+                case deadline_missed:
+                line << "Deadline missed!";
+                break;
+                case steered_to_neutral:
+                line << "Steering to Neutral Position: 0";
+                break;
+                case watchdog_tripped:
+                line << "Watchdog: steering to Neutral Position: 0 (vehicle "
+                     << record.count << ")";
+                break;
+                case failover:
+                line << "Failover to controller " << record.handle << " in "
+                     << record.value << " ms";
+                break;
+                case safe_state:
+                line << "Safe state reached in " << record.value << " ms";
+                break;
+                case command_written:
+                line << "Writing Steering Position: " << record.value;
+                break;
+                case status_dropped:
+                line << "Status dropped by the display (vehicle " << record.count << ")";
+                break;
+                case command_stale:
+                line << "Stale command from controller " << record.handle << " dropped ("
+                     << record.value << " ms old)";
+                break;
+                case control_cycle:
+                line << "Control cycle: tracking error " << record.value
+                     << " deg, loop time " << record.count / 1000.0 << " us";
+                break;
+                default:
+                line << "Unknown event " << record.event;
+                break;
+            }
+            line << '\n';
+        }
+
+        ring_buffer::MpscRing<Record> records_;
+        std::ostream& out_;
+        std::stringstream line_;  // reused, grows to the longest record
+        const std::string empty_;
+        std::atomic<int> threshold_;
+        std::atomic<uint64_t> dropped_;
+        uint64_t reported_dropped_;  // logger thread only
+        int users_;
+        std::atomic<bool> stop_;
+        std::mutex mutex_;
+        std::thread thread_;
+    };
+
+    // The logger of the process, shared by its components
+    inline Logger& logger()
+    {
+        static Logger instance;
+        return instance;
+    }
+
+    // Logs an event on the logger of the process
+    inline void record(
+        Event event,
+        const dds::core::InstanceHandle& handle = dds::core::InstanceHandle::nil(),
+        int64_t count = 0,
+        int64_t total = 0,
+        double value = 0.0)
+    {
+        logger().record(event, handle, count, total, value);
+    }
+
+    // Runs the logger of the process, at the severity of a --verbosity, for
+    // the lifetime of an app (or of a component of the launcher); the
+    // queued records are written when the last session ends
+    class Session {
+    public:
+        explicit Session(rti::config::Verbosity verbosity)
+        {
+            logger().threshold(threshold_of(verbosity));
+            logger().start();
+        }
+
+        ~Session() { logger().stop(); }
+
+    private:
+        Session(const Session&);
+        Session& operator=(const Session&);
+    };
+
+}  // namespace eventlog
+
+#endif  // EVENTLOG_HPP
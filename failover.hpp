@@ -0,0 +1,149 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef FAILOVER_HPP
+#define FAILOVER_HPP
+
+#include <iostream>
+#include <cstdint>
+
+#include <dds/core/ddscore.hpp>
+
+#include "latency.hpp"   // for the reaction time histograms
+#include "eventlog.hpp"  // for the failover events
+
+namespace failover {
+
+    // Overrides the liveliness lease duration and the deadline period of
+    // a DataWriter or DataReader QoS (0: keep the configured value). The
+    // controllers and the actuator must use the same values: a reader
+    // requests at least the lease and deadline its writers offer.
+    template <typename Qos>
+    void override_timing(Qos& qos, unsigned int lease_ms, unsigned int deadline_ms)
+    {
+        if (lease_ms > 0) {
+            dds::core::policy::Liveliness liveliness =
+                    qos.template policy<dds::core::policy::Liveliness>();
+            liveliness.lease_duration(dds::core::Duration::from_millisecs(lease_ms));
+            qos << liveliness;
+        }
+        if (deadline_ms > 0) {
+            qos << dds::core::policy::Deadline(
+                    dds::core::Duration::from_millisecs(deadline_ms));
+        }
+    }
+
+    // Measures how fast the actuator reacts to the loss of the controller
+    // that owns it. All times are on the system clock, from the reception
+    // of the last sample of the lost (primary) controller to:
+    // - detection: the liveliness loss, unmatch or missed deadline
+    // - takeover: the reception of the first sample applied from another
+    //   (secondary) controller
+    // - safe state: the write of the neutral position, if no other
+    //   controller takes over
+    // Called from the control loop only.
+    class ReactionTimer {
+    public:
+        ReactionTimer()
+            : owner_(dds::core::InstanceHandle::nil()),
+            last_sample_ns_(-1),
+            lost_(false),
+            primary_(dds::core::InstanceHandle::nil()),
+            primary_last_sample_ns_(-1) {}
+
+        // A sample from 'writer', received at 'reception_ns', was applied
+        void sample_applied(const dds::core::InstanceHandle& writer, int64_t reception_ns)
+        {
+            if (lost_ && writer != primary_) {
+                int64_t takeover_ns = reception_ns - primary_last_sample_ns_;
+                takeover_.record(takeover_ns);
+                eventlog::record(eventlog::failover, writer, 0, 0, takeover_ns / 1e6);
+                lost_ = false;
+            }
+            owner_ = writer;
+            last_sample_ns_ = reception_ns;
+        }
+
+        // The liveliness of 'writer' was lost, or it was unmatched
+        void writer_lost(const dds::core::InstanceHandle& writer, int64_t now_ns)
+        {
+            if (writer == owner_) {
+                owner_lost(now_ns);
+            }
+        }
+
+        // The owner stopped writing (e.g. a missed deadline)
+        void owner_lost(int64_t now_ns)
+        {
+            if (lost_ || last_sample_ns_ < 0) {
+                return;  // already timing, or no owner yet
+            }
+            lost_ = true;
+            primary_ = owner_;
+            primary_last_sample_ns_ = last_sample_ns_;
+            detection_.record(now_ns - primary_last_sample_ns_);
+        }
+
+        // The neutral position was written (reported later, e.g. from the
+        // thread of an actuator model); a sample applied since supersedes it
+        void safe_state(int64_t now_ns)
+        {
+            if (last_sample_ns_ > now_ns) {
+                return;
+            }
+            if (lost_) {
+                int64_t safe_state_ns = now_ns - primary_last_sample_ns_;
+                safe_state_.record(safe_state_ns);
+                eventlog::record(
+                    eventlog::safe_state,
+                    dds::core::InstanceHandle::nil(),
+                    0,
+                    0,
+                    safe_state_ns / 1e6);
+                lost_ = false;
+            }
+            // A controller applied after the safe state is not a takeover
+            owner_ = dds::core::InstanceHandle::nil();
+            last_sample_ns_ = -1;
+        }
+
+        // Adds the reaction times of another column (e.g. of a fleet)
+        void add(const ReactionTimer& other)
+        {
+            detection_.add(other.detection_);
+            takeover_.add(other.takeover_);
+            safe_state_.add(other.safe_state_);
+        }
+
+        void print_statistics(std::ostream& out) const
+        {
+            out << "Reaction times in milliseconds, from the last sample of the lost controller:"
+                << std::endl;
+            detection_.print(out, "detection", 1e6);
+            takeover_.print(out, "takeover", 1e6);
+            safe_state_.print(out, "safe state", 1e6);
+        }
+
+    private:
+        dds::core::InstanceHandle owner_;
+        int64_t last_sample_ns_;
+        bool lost_;
+        dds::core::InstanceHandle primary_;
+        int64_t primary_last_sample_ns_;
+        latency::Histogram detection_;
+        latency::Histogram takeover_;
+        latency::Histogram safe_state_;
+    };
+
+}  // namespace failover
+
+#endif  // FAILOVER_HPP
@@ -0,0 +1,80 @@
+#!/bin/bash
+######################################################################
+# failover_benchmark.sh
+# (C) Copyright 2020-2025 Real-Time Innovations, Inc.  All rights reserved.
+#
+# The use of this software is governed by the terms specified in the RTI
+# Labs License Agreement, available at https://www.rti.com/terms/RTILabs.
+#
+# By accessing, downloading, or otherwise using this software, you agree to
+# be bound by those terms.
+######################################################################
+#
+# Measures the failover and safe-state reaction times of the SteeringColumn
+# for a range of liveliness lease durations and deadline periods.
+#
+# For each setting, an actuator and a secondary controller run while a
+# primary controller is repeatedly started and crashed (SIGKILL, so that
+# only the liveliness lease or the deadline reveals the loss); then the
+# secondary is crashed as well, to measure the safe-state reaction. The
+# actuator prints the reaction time distributions on exit.
+#
+# Usage:
+#     ./failover_benchmark.sh <arch> [runs]
+# e.g.
+#     LEASES="200 1000" DEADLINES="50 200" ./failover_benchmark.sh x64Linux4gcc7.3.0 20
+
+ARCH=$1
+RUNS=${2:-10}
+LEASES=${LEASES:-"100 500 1000"}
+DEADLINES=${DEADLINES:-"20 100 500"}
+RATE=${RATE:-100}
+RESULTS=${RESULTS:-failover_results}
+DATABUSHOME=${DATABUSHOME:-bus}
+
+if [ -z "$ARCH" ]; then
+    echo "Usage: $0 <arch> [runs]"
+    exit 1
+fi
+
+RUN="$DATABUSHOME/bin/run Steering"
+APPS=./objs/$ARCH
+mkdir -p $RESULTS
+
+# Starts a controller in the background; its pid is in $!
+start_controller() {
+    $RUN $APPS/SteeringController --strength $1 --rate $RATE \
+        --liveliness-lease $lease --deadline $deadline > /dev/null &
+}
+
+# Crashes the controller(s) of a strength, without a chance to clean up
+crash_controller() {
+    pkill -KILL -f "SteeringController --strength $1 "
+}
+
+for lease in $LEASES; do
+    for deadline in $DEADLINES; do
+        log=$RESULTS/lease${lease}_deadline${deadline}.txt
+        echo "Liveliness lease $lease ms, deadline $deadline ms: $RUNS runs"
+
+        $RUN $APPS/SteeringColumn \
+            --liveliness-lease $lease --deadline $deadline > $log &
+        column=$!
+        # Leave time for the reaction (and the discovery of the next run)
+        settle=$(( (lease > deadline ? lease : deadline) / 1000 + 2 ))
+
+        for run in $(seq $RUNS); do
+            start_controller 1
+            start_controller 2
+            sleep 2
+            crash_controller 2
+            sleep $settle
+            crash_controller 1
+            sleep $settle
+        done
+
+        pkill -INT -f "SteeringColumn --liveliness-lease"
+        wait $column
+        grep -A3 "^Reaction times" $log
+    done
+done
@@ -0,0 +1,94 @@
+#!/bin/bash
+######################################################################
+# fault_benchmark.sh
+# (C) Copyright 2020-2025 Real-Time Innovations, Inc.  All rights reserved.
+#
+# The use of this software is governed by the terms specified in the RTI
+# Labs License Agreement, available at https://www.rti.com/terms/RTILabs.
+#
+# By accessing, downloading, or otherwise using this software, you agree to
+# be bound by those terms.
+######################################################################
+#
+# Measures the SteeringColumn under network degradation and controller
+# crashes, on this host and without a network.
+#
+# For each scenario, the apps run over shared memory and write through a
+# simulated link (--link: loss, delay, jitter and reordering of the
+# commands and of the status). In each run a primary and a secondary
+# controller start, then crash (--crash-after, SIGKILL) one after the
+# other, so that the actuator fails over and then steers to the safe
+# state. The actuator prints on exit the command age (the end-to-end
+# latency, including the link), the deadline misses and the reaction
+# times.
+#
+# Usage:
+#     ./fault_benchmark.sh <arch> [runs]
+# e.g.
+#     LEASE=200 DEADLINE=50 CRASH=3000 ./fault_benchmark.sh x64Linux4gcc7.3.0 5
+
+ARCH=$1
+RUNS=${2:-3}
+RATE=${RATE:-100}
+LEASE=${LEASE:-500}
+DEADLINE=${DEADLINE:-100}
+CRASH=${CRASH:-5000}  # ms, the primary crashes then, the secondary as long after
+RESULTS=${RESULTS:-fault_results}
+DATABUSHOME=${DATABUSHOME:-bus}
+
+if [ -z "$ARCH" ]; then
+    echo "Usage: $0 <arch> [runs]"
+    exit 1
+fi
+
+RUN="$DATABUSHOME/bin/run Steering"
+APPS=./objs/$ARCH
+mkdir -p $RESULTS
+
+# Link profiles: <loss %>,<delay us>,<jitter us>,<reorder %>
+SCENARIOS=(ideal lossy delayed jittery reordering degraded)
+LINKS=(
+    "0,0,0,0"
+    "5,0,0,0"
+    "0,20000,0,0"
+    "0,5000,5000,0"
+    "0,1000,0,10"
+    "5,10000,5000,5"
+)
+
+# Options of every app: timing of the failover and the simulated link
+options() {
+    echo "--transport shmem --liveliness-lease $LEASE --deadline $DEADLINE --link $1"
+}
+
+# Leave time for the reaction (and the discovery of the next run)
+settle=$(( (LEASE > DEADLINE ? LEASE : DEADLINE) / 1000 + 2 ))
+
+for i in ${!SCENARIOS[@]}; do
+    scenario=${SCENARIOS[$i]}
+    link=${LINKS[$i]}
+    log=$RESULTS/$scenario.txt
+    echo "Scenario $scenario (link $link): $RUNS runs"
+
+    $RUN $APPS/SteeringColumn $(options $link) > $log &
+    column=$!
+    $RUN $APPS/SteeringDisplay --transport shmem > /dev/null &
+    sleep 2  # discovery
+
+    for run in $(seq $RUNS); do
+        $RUN $APPS/SteeringController --strength 2 --rate $RATE $(options $link) \
+            --crash-after $CRASH > /dev/null &
+        primary=$!
+        $RUN $APPS/SteeringController --strength 1 --rate $RATE $(options $link) \
+            --crash-after $(( 2 * CRASH )) > /dev/null &
+        secondary=$!
+        wait $primary $secondary
+        sleep $settle
+    done
+
+    pkill -INT -f "SteeringDisplay --transport shmem"
+    pkill -INT -f "SteeringColumn --transport shmem"
+    wait $column
+    grep -e "^Command age" -e "^Deadline misses" -e "^Simulated link" $log
+    grep -A3 "^Reaction times" $log
+done
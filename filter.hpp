@@ -0,0 +1,121 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef FILTER_HPP
+#define FILTER_HPP
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+#include <dds/domain/ddsdomain.hpp>
+#include <dds/pub/ddspub.hpp>
+#include <dds/sub/ddssub.hpp>
+#include <dds/topic/ddstopic.hpp>
+
+namespace filter {
+
+    // Name the delta filter is registered with, on the participants of the
+    // actuator (to filter on the writer side) and of the displays
+    const char *const DELTA_FILTER_NAME = "SteeringDeltaFilter";
+
+    // Passes a steering sample only when its position differs by at least
+    // the minimum change (the filter parameter, in degrees) from the last
+    // one passed to the same DataReader.
+    //
+    // The filter is stateful, which an SQL filter expression cannot be:
+    // each DataReader gets its own state when its filter is compiled. When
+    // the actuator registers the filter too, its DataWriters evaluate it for
+    // every matched display, so the filtered samples are never sent.
+    struct DeltaState {
+        float min_change;
+        bool passed;
+        float last_position;
+    };
+
+    template <typename T>
+    class DeltaFilter : public rti::topic::ContentFilter<T, DeltaState> {
+    public:
+        DeltaState& compile(
+            const std::string& expression,
+            const dds::core::StringSeq& parameters,
+            const dds::core::optional<dds::core::xtypes::DynamicType>& type_code,
+            const std::string& type_class_name,
+            DeltaState *old_compile_data) override
+        {
+            // A recompiled filter (new parameters) keeps its last position
+            DeltaState *state = old_compile_data;
+            if (state == NULL) {
+                state = new DeltaState();
+                state->passed = false;
+                state->last_position = 0.0f;
+            }
+            state->min_change = parameters.empty()
+                    ? 0.0f
+                    : static_cast<float>(std::atof(parameters[0].c_str()));
+            return *state;
+        }
+
+        bool evaluate(
+            DeltaState& state,
+            const T& sample,
+            const rti::topic::FilterSampleInfo& meta_data) override
+        {
+            if (state.passed
+                    && std::fabs(sample.position() - state.last_position) < state.min_change) {
+                return false;
+            }
+            state.passed = true;
+            state.last_position = sample.position();
+            return true;
+        }
+
+        void finalize(DeltaState& state) override
+        {
+            delete &state;
+        }
+    };
+
+    // Makes the delta filter available to the entities of a participant.
+    // Must be called before the participant is enabled.
+    template <typename T>
+    void register_delta_filter(dds::domain::DomainParticipant& participant)
+    {
+        participant.extensions().register_contentfilter(
+            rti::topic::CustomFilter<DeltaFilter<T>>(new DeltaFilter<T>()),
+            DELTA_FILTER_NAME);
+    }
+
+    // Creates the ContentFilteredTopic of the delta filter on the topic of
+    // a configured DataReader, registering the filter
+    template <typename T>
+    dds::topic::ContentFilteredTopic<T> create_delta_topic(
+        const dds::sub::DataReader<T>& configured,
+        float min_change)
+    {
+        dds::domain::DomainParticipant participant = configured.subscriber().participant();
+        register_delta_filter<T>(participant);
+
+        dds::topic::Topic<T> topic = dds::topic::find<dds::topic::Topic<T>>(
+            participant,
+            configured.topic_description().name());
+        dds::topic::Filter delta_filter("", dds::core::StringSeq(1, std::to_string(min_change)));
+        delta_filter->name(DELTA_FILTER_NAME);
+        return dds::topic::ContentFilteredTopic<T>(
+            topic,
+            topic.name() + "/delta",
+            delta_filter);
+    }
+
+}  // namespace filter
+
+#endif  // FILTER_HPP
@@ -0,0 +1,76 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef FLEET_HPP
+#define FLEET_HPP
+
+#include <string>
+
+#include <dds/pub/ddspub.hpp>
+#include <dds/sub/ddssub.hpp>
+
+namespace fleet {
+
+    // The Steering types have no key, so the vehicles of a fleet are kept
+    // apart by partition: the steering samples of vehicle <n> are published
+    // and subscribed in the partition "vehicle/<n>". Ownership, liveliness
+    // and deadlines then apply to each vehicle separately, as they would to
+    // each instance of a keyed type.
+    inline std::string partition_of(unsigned int vehicle)
+    {
+        return "vehicle/" + std::to_string(vehicle);
+    }
+
+    // Creates a DataWriter with the topic and QoS of a configured one, in
+    // its own Publisher in the partition of 'vehicle'
+    template <typename T>
+    dds::pub::DataWriter<T> create_writer(
+        const dds::pub::DataWriter<T>& configured,
+        unsigned int vehicle)
+    {
+        dds::pub::qos::PublisherQos publisher_qos = configured.publisher().qos();
+        publisher_qos << dds::core::policy::Partition(partition_of(vehicle));
+        dds::pub::Publisher publisher(configured.publisher().participant(), publisher_qos);
+        return dds::pub::DataWriter<T>(publisher, configured.topic(), configured.qos());
+    }
+
+    // Creates a DataReader of 'topic' (e.g. a ContentFilteredTopic of the
+    // configured one) with the QoS of a configured DataReader, in its own
+    // Subscriber in the partition of 'vehicle'
+    template <typename T, typename TOPIC>
+    dds::sub::DataReader<T> create_reader(
+        const dds::sub::DataReader<T>& configured,
+        unsigned int vehicle,
+        const TOPIC& topic)
+    {
+        dds::sub::qos::SubscriberQos subscriber_qos = configured.subscriber().qos();
+        subscriber_qos << dds::core::policy::Partition(partition_of(vehicle));
+        dds::sub::Subscriber subscriber(configured.subscriber().participant(), subscriber_qos);
+        return dds::sub::DataReader<T>(subscriber, topic, configured.qos());
+    }
+
+    // Creates a DataReader with the topic and QoS of a configured one, in
+    // its own Subscriber in the partition of 'vehicle'
+    template <typename T>
+    dds::sub::DataReader<T> create_reader(
+        const dds::sub::DataReader<T>& configured,
+        unsigned int vehicle)
+    {
+        dds::topic::Topic<T> topic = dds::topic::find<dds::topic::Topic<T>>(
+            configured.subscriber().participant(),
+            configured.topic_description().name());
+        return create_reader(configured, vehicle, topic);
+    }
+
+}  // namespace fleet
+
+#endif  // FLEET_HPP
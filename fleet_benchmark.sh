@@ -0,0 +1,60 @@
+#!/bin/bash
+######################################################################
+# fleet_benchmark.sh
+# (C) Copyright 2020-2025 Real-Time Innovations, Inc.  All rights reserved.
+#
+# The use of this software is governed by the terms specified in the RTI
+# Labs License Agreement, available at https://www.rti.com/terms/RTILabs.
+#
+# By accessing, downloading, or otherwise using this software, you agree to
+# be bound by those terms.
+######################################################################
+#
+# Measures how the SteeringColumn scales with the size of the fleet it
+# serves and with the number of its worker threads (cores).
+#
+# For each fleet size and worker count, a controller drives every vehicle
+# of the fleet at RATE Hz for DURATION seconds, and the actuator reports
+# the commands it took per second and its dispatch latency (from the
+# reception of a command to its processing) on exit.
+#
+# Usage:
+#     ./fleet_benchmark.sh <arch>
+# e.g.
+#     VEHICLES="1 10 100 500" WORKERS="1 2 4" ./fleet_benchmark.sh x64Linux4gcc7.3.0
+
+ARCH=$1
+VEHICLES=${VEHICLES:-"1 10 100"}
+WORKERS=${WORKERS:-"1 2 4"}
+RATE=${RATE:-100}
+DURATION=${DURATION:-10}
+RESULTS=${RESULTS:-fleet_results}
+DATABUSHOME=${DATABUSHOME:-bus}
+
+if [ -z "$ARCH" ]; then
+    echo "Usage: $0 <arch>"
+    exit 1
+fi
+
+RUN="$DATABUSHOME/bin/run Steering"
+APPS=./objs/$ARCH
+mkdir -p $RESULTS
+
+for vehicles in $VEHICLES; do
+    for workers in $WORKERS; do
+        log=$RESULTS/vehicles${vehicles}_workers${workers}.txt
+        echo "$vehicles vehicles, $workers workers, $RATE Hz:"
+
+        $RUN $APPS/SteeringColumn --vehicles $vehicles --workers $workers > $log &
+        column=$!
+        $RUN $APPS/SteeringController --vehicles $vehicles --rate $RATE > /dev/null &
+        controller=$!
+
+        sleep $DURATION
+        pkill -INT -f "SteeringController --vehicles $vehicles "
+        wait $controller
+        pkill -INT -f "SteeringColumn --vehicles $vehicles "
+        wait $column
+        grep -e "^Commands taken" -e "^Dispatch latency" $log
+    done
+done
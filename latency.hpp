@@ -0,0 +1,263 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef LATENCY_HPP
+#define LATENCY_HPP
+
+#include <iostream>
+#include <iomanip>  // For std::setw
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <sys/resource.h>
+#include <dds/core/ddscore.hpp>
+
+namespace latency {
+
+    // Monotonic timestamp in nanoseconds, for measuring intervals
+    inline int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Timestamp in nanoseconds on the system (wall) clock, which Connext uses
+    // for the source and reception timestamps of samples
+    inline int64_t system_now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // CPU time in nanoseconds (user and system) used so far by every thread
+    // of the process, including the middleware's
+    inline int64_t cpu_ns()
+    {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+        return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000LL
+                + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000LL;
+    }
+
+    inline int64_t to_ns(const dds::core::Time& time)
+    {
+        return static_cast<int64_t>(time.sec()) * 1000000000LL + time.nanosec();
+    }
+
+    // HDR-style log-linear histogram of non-negative values (e.g. nanoseconds).
+    //
+    // Values below SUB_BUCKET_COUNT are counted exactly; above that, every
+    // power-of-two range is split into SUB_BUCKET_COUNT/2 linear sub-buckets,
+    // so the relative error of any reported value is below 2%. Recording is
+    // a couple of shifts and an increment, and never allocates.
+    class Histogram {
+    public:
+        static const int SUB_BUCKET_BITS = 7;
+        static const uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+        static const uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+        static const size_t BUCKET_COUNT =
+            SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * SUB_BUCKET_HALF;
+
+        Histogram() : counts_(BUCKET_COUNT, 0) { reset(); }
+
+        void record(int64_t value)
+        {
+            uint64_t v = value < 0 ? 0 : static_cast<uint64_t>(value);
+            counts_[index_of(v)]++;
+            total_++;
+            if (v < min_) {
+                min_ = v;
+            }
+            if (v > max_) {
+                max_ = v;
+            }
+        }
+
+        // Adds 'count' values to the bucket at 'index', e.g. to merge counts
+        // recorded elsewhere. The min and max become the bucket bounds.
+        void add_bucket(size_t index, uint64_t count)
+        {
+            counts_[index] += count;
+            total_ += count;
+            if (lowest_value_of(index) < min_) {
+                min_ = lowest_value_of(index);
+            }
+            if (highest_value_of(index) > max_) {
+                max_ = highest_value_of(index);
+            }
+        }
+
+        // Adds all the values of another histogram
+        void add(const Histogram& other)
+        {
+            for (size_t i = 0; i < BUCKET_COUNT; i++) {
+                counts_[i] += other.counts_[i];
+            }
+            total_ += other.total_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+
+        void reset()
+        {
+            std::fill(counts_.begin(), counts_.end(), 0);
+            total_ = 0;
+            min_ = UINT64_MAX;
+            max_ = 0;
+        }
+
+        uint64_t count() const { return total_; }
+        uint64_t min() const { return total_ == 0 ? 0 : min_; }
+        uint64_t max() const { return max_; }
+
+        // Value at or below which the given percentage (0-100) of samples fall
+        uint64_t percentile(double percent) const
+        {
+            if (total_ == 0) {
+                return 0;
+            }
+            uint64_t rank = static_cast<uint64_t>(percent / 100.0 * total_ + 0.5);
+            if (rank < 1) {
+                rank = 1;
+            }
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BUCKET_COUNT; i++) {
+                seen += counts_[i];
+                if (seen >= rank) {
+                    uint64_t value = highest_value_of(i);
+                    return value > max_ ? max_ : value;
+                }
+            }
+            return max_;
+        }
+
+        // Prints a one line summary, scaling values by 'divisor' (e.g. 1000
+        // to report nanoseconds as microseconds)
+        void print(std::ostream& out, const char *label, double divisor) const
+        {
+            std::ios::fmtflags flags(out.flags());
+            std::streamsize precision(out.precision());
+            out << std::left << std::setw(24) << std::setfill(' ') << label
+                << std::fixed << std::setprecision(1)
+                << " count " << count()
+                << "  min " << min() / divisor
+                << "  p50 " << percentile(50.0) / divisor
+                << "  p99 " << percentile(99.0) / divisor
+                << "  p99.9 " << percentile(99.9) / divisor
+                << "  max " << max() / divisor << std::endl;
+            out.flags(flags);
+            out.precision(precision);
+        }
+
+        static size_t index_of(uint64_t value)
+        {
+            if (value < SUB_BUCKET_COUNT) {
+                return static_cast<size_t>(value);
+            }
+            int msb = 63 - __builtin_clzll(value);
+            int shift = msb - (SUB_BUCKET_BITS - 1);
+            return static_cast<size_t>(SUB_BUCKET_COUNT
+                + (shift - 1) * SUB_BUCKET_HALF
+                + ((value >> shift) - SUB_BUCKET_HALF));
+        }
+
+        static uint64_t lowest_value_of(size_t index)
+        {
+            if (index < SUB_BUCKET_COUNT) {
+                return index;
+            }
+            uint64_t offset = index - SUB_BUCKET_COUNT;
+            int shift = static_cast<int>(offset / SUB_BUCKET_HALF) + 1;
+            uint64_t mantissa = offset % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+            return mantissa << shift;
+        }
+
+        static uint64_t highest_value_of(size_t index)
+        {
+            if (index < SUB_BUCKET_COUNT) {
+                return index;
+            }
+            uint64_t offset = index - SUB_BUCKET_COUNT;
+            int shift = static_cast<int>(offset / SUB_BUCKET_HALF) + 1;
+            uint64_t mantissa = offset % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+            return ((mantissa + 1) << shift) - 1;
+        }
+
+    private:
+        std::vector<uint64_t> counts_;
+        uint64_t total_;
+        uint64_t min_;
+        uint64_t max_;
+    };
+
+    // Matches echoed steering positions to the commands that produced them.
+    //
+    // A benchmark command carries no extra fields, so it is "stamped" by its
+    // position: positions are drawn from a fixed grid of TAG_COUNT exactly
+    // representable values in [-180, +180), and the send time of each
+    // outstanding command is kept in a slot indexed by its tag. An echoed
+    // SteeringActual with the same position completes the round trip.
+    class RoundTripTracker {
+    public:
+        static const int TAG_RESOLUTION = 64;  // tags per degree
+        static const int TAG_COUNT = 360 * TAG_RESOLUTION;
+
+        RoundTripTracker() : sent_ns_(TAG_COUNT, 0), next_tag_(1) {}
+
+        // Position to command for the next sample, recording its send time
+        float stamp(int64_t send_ns)
+        {
+            int tag = next_tag_;
+            // Skip the neutral position: the actuator writes it on its own
+            // when it steers to the safe state
+            next_tag_ = (next_tag_ + 1) % TAG_COUNT;
+            if (next_tag_ == 180 * TAG_RESOLUTION) {
+                next_tag_++;
+            }
+            sent_ns_[tag] = send_ns;
+            return -180.0f + static_cast<float>(tag) / TAG_RESOLUTION;
+        }
+
+        // Round trip time of an echoed position, or -1 if it does not match
+        // an outstanding command
+        int64_t match(float position, int64_t receive_ns)
+        {
+            double scaled = (static_cast<double>(position) + 180.0) * TAG_RESOLUTION;
+            if (scaled < 0.0 || scaled >= TAG_COUNT) {
+                return -1;
+            }
+            int tag = static_cast<int>(scaled + 0.5) % TAG_COUNT;
+            int64_t sent = sent_ns_[tag];
+            if (sent == 0) {
+                return -1;
+            }
+            sent_ns_[tag] = 0;
+            return receive_ns - sent;
+        }
+
+        // Forget an outstanding command (e.g. it timed out)
+        void cancel(float position)
+        {
+            match(position, 0);
+        }
+
+    private:
+        std::vector<int64_t> sent_ns_;
+        int next_tag_;
+    };
+
+}  // namespace latency
+
+#endif  // LATENCY_HPP
@@ -0,0 +1,293 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <ostream>
+#include <algorithm>  // for std::remove()
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <fstream>
+#include <cstdio>   // for std::rename()
+
+#include "latency.hpp"  // for the histogram buckets
+
+namespace metrics {
+
+    class Metric;
+
+    // All live metrics, in registration order, for the exporter.
+    // Registration happens at startup; updating a metric never locks.
+    class Registry {
+    public:
+        void add(Metric *metric)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            metrics_.push_back(metric);
+        }
+
+        void remove(Metric *metric)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            metrics_.erase(std::remove(metrics_.begin(), metrics_.end(), metric), metrics_.end());
+        }
+
+        // Writes all metrics in the Prometheus text exposition format
+        void write(std::ostream& out);
+
+    private:
+        std::mutex mutex_;
+        std::vector<Metric *> metrics_;
+    };
+
+    inline Registry& registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    // A named metric of a steering component (SteeringColumn, ...)
+    class Metric {
+    public:
+        Metric(const char *name, const char *help, const char *component)
+            : name_(name), help_(help), component_(component)
+        {
+            registry().add(this);
+        }
+
+        virtual ~Metric()
+        {
+            registry().remove(this);
+        }
+
+        const char *name() const { return name_; }
+        const char *help() const { return help_; }
+        const char *component() const { return component_; }
+
+        virtual const char *type() const = 0;
+        virtual void write_samples(std::ostream& out) const = 0;
+
+    private:
+        Metric(const Metric&);
+        Metric& operator=(const Metric&);
+
+        const char *name_;
+        const char *help_;
+        const char *component_;
+    };
+
+    // Monotonic event counter
+    class Counter : public Metric {
+    public:
+        Counter(const char *name, const char *help, const char *component)
+            : Metric(name, help, component), value_(0) {}
+
+        void increment(uint64_t count = 1)
+        {
+            value_.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+        const char *type() const { return "counter"; }
+
+        void write_samples(std::ostream& out) const
+        {
+            out << name() << "{component=\"" << component() << "\"} " << value() << "\n";
+        }
+
+    private:
+        std::atomic<uint64_t> value_;
+    };
+
+    // Distribution of durations in nanoseconds, with the same buckets as
+    // latency::Histogram, exported as a summary in seconds
+    class Histogram : public Metric {
+    public:
+        Histogram(const char *name, const char *help, const char *component)
+            : Metric(name, help, component),
+            counts_(new std::atomic<uint64_t>[latency::Histogram::BUCKET_COUNT]),
+            sum_ns_(0)
+        {
+            for (size_t i = 0; i < latency::Histogram::BUCKET_COUNT; i++) {
+                counts_[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        ~Histogram() { delete[] counts_; }
+
+        void record(int64_t value_ns)
+        {
+            uint64_t value = value_ns < 0 ? 0 : static_cast<uint64_t>(value_ns);
+            counts_[latency::Histogram::index_of(value)].fetch_add(1, std::memory_order_relaxed);
+            sum_ns_.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        // Copy of the current distribution, for reporting
+        latency::Histogram snapshot() const
+        {
+            latency::Histogram histogram;
+            for (size_t i = 0; i < latency::Histogram::BUCKET_COUNT; i++) {
+                uint64_t count = counts_[i].load(std::memory_order_relaxed);
+                if (count > 0) {
+                    histogram.add_bucket(i, count);
+                }
+            }
+            return histogram;
+        }
+
+        const char *type() const { return "summary"; }
+
+        void write_samples(std::ostream& out) const
+        {
+            static const double quantiles[] = { 0.5, 0.99, 0.999 };
+            latency::Histogram histogram = snapshot();
+            for (size_t i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); i++) {
+                out << name() << "{component=\"" << component()
+                    << "\",quantile=\"" << quantiles[i] << "\"} "
+                    << histogram.percentile(quantiles[i] * 100.0) / 1e9 << "\n";
+            }
+            out << name() << "_sum{component=\"" << component() << "\"} "
+                << sum_ns_.load(std::memory_order_relaxed) / 1e9 << "\n";
+            out << name() << "_count{component=\"" << component() << "\"} "
+                << histogram.count() << "\n";
+        }
+
+    private:
+        std::atomic<uint64_t> *counts_;
+        std::atomic<uint64_t> sum_ns_;
+    };
+
+    inline void Registry::write(std::ostream& out)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < metrics_.size(); i++) {
+            // Several components (in the same process) may report the same
+            // metric: write all the samples of a name as one group
+            bool written = false;
+            for (size_t j = 0; j < i && !written; j++) {
+                written = (std::string(metrics_[j]->name()) == metrics_[i]->name());
+            }
+            if (written) {
+                continue;
+            }
+            out << "# HELP " << metrics_[i]->name() << " " << metrics_[i]->help() << "\n";
+            out << "# TYPE " << metrics_[i]->name() << " " << metrics_[i]->type() << "\n";
+            for (size_t j = i; j < metrics_.size(); j++) {
+                if (std::string(metrics_[j]->name()) == metrics_[i]->name()) {
+                    metrics_[j]->write_samples(out);
+                }
+            }
+        }
+    }
+
+    // The metrics every steering component reports
+    struct ComponentMetrics {
+        explicit ComponentMetrics(const char *component)
+            : samples_taken(
+                "steering_samples_taken_total",
+                "Valid samples taken from the DataReaders",
+                component),
+            samples_written(
+                "steering_samples_written_total",
+                "Samples written by the DataWriters",
+                component),
+            deadline_misses(
+                "steering_deadline_misses_total",
+                "Requested deadlines missed",
+                component),
+            liveliness_changes(
+                "steering_liveliness_changes_total",
+                "Liveliness changes of the matched writers",
+                component),
+            safety_activations(
+                "steering_safety_activations_total",
+                "Times the actuator steered to the safe (neutral) position",
+                component),
+            dispatch_duration(
+                "steering_dispatch_duration_seconds",
+                "Time spent handling a data or status event",
+                component) {}
+
+        Counter samples_taken;
+        Counter samples_written;
+        Counter deadline_misses;
+        Counter liveliness_changes;
+        Counter safety_activations;
+        Histogram dispatch_duration;
+    };
+
+    // Periodically writes a snapshot of all metrics to a file, for a
+    // Prometheus node exporter (textfile collector) or any other scraper.
+    // The file is replaced atomically, so a reader never sees a partial one.
+    class Exporter {
+    public:
+        Exporter(const std::string& path, unsigned int period_ms)
+            : path_(path), period_ms_(period_ms > 0 ? period_ms : 1000), stop_(false)
+        {
+            if (!path_.empty()) {
+                thread_ = std::thread(&Exporter::run, this);
+            }
+        }
+
+        ~Exporter()
+        {
+            if (thread_.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stop_ = true;
+                }
+                wakeup_.notify_one();
+                thread_.join();
+            }
+        }
+
+        void export_now()
+        {
+            std::string temporary_path = path_ + ".tmp";
+            {
+                std::ofstream out(temporary_path.c_str());
+                if (!out) {
+                    return;
+                }
+                registry().write(out);
+            }
+            std::rename(temporary_path.c_str(), path_.c_str());
+        }
+
+    private:
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stop_) {
+                wakeup_.wait_for(lock, std::chrono::milliseconds(period_ms_));
+                export_now();
+            }
+        }
+
+        std::string path_;
+        unsigned int period_ms_;
+        bool stop_;
+        std::mutex mutex_;
+        std::condition_variable wakeup_;
+        std::thread thread_;
+    };
+
+}  // namespace metrics
+
+#endif  // METRICS_HPP
@@ -0,0 +1,234 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef NETSIM_HPP
+#define NETSIM_HPP
+
+#include <iostream>
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include <unistd.h>  // for getpid()
+
+#include "latency.hpp"   // for now_ns() and system_now_ns()
+#include "periodic.hpp"  // for the monotonic condition variable
+
+namespace netsim {
+
+    // Impairments of a simulated link, applied to the samples an app writes
+    struct LinkProfile {
+        LinkProfile() : loss(0.0), delay_us(0), jitter_us(0), reorder(0.0) {}
+
+        bool enabled() const
+        {
+            return loss > 0.0 || delay_us > 0 || jitter_us > 0 || reorder > 0.0;
+        }
+
+        double loss;         // probability a sample is lost
+        unsigned int delay_us;
+        unsigned int jitter_us;  // the delay varies by up to +/- jitter_us
+        double reorder;      // probability a sample is held back
+    };
+
+    // Parses "<loss %>,<delay us>,<jitter us>,<reorder %>", e.g. "1,2000,500,0"
+    inline bool parse_profile(const char *text, LinkProfile& profile)
+    {
+        double loss_percent = 0.0;
+        double reorder_percent = 0.0;
+        if (sscanf(text, "%lf,%u,%u,%lf",
+                &loss_percent, &profile.delay_us, &profile.jitter_us, &reorder_percent) != 4
+                || loss_percent < 0.0 || loss_percent > 100.0
+                || reorder_percent < 0.0 || reorder_percent > 100.0) {
+            return false;
+        }
+        profile.loss = loss_percent / 100.0;
+        profile.reorder = reorder_percent / 100.0;
+        return true;
+    }
+
+    const size_t DEFAULT_CAPACITY = 4096;  // samples in flight
+
+    // A lossy, delaying link between the writing code and a DataWriter, so
+    // that the apps can be run against network degradation on one host
+    // (e.g. over shared memory), without a network or a special transport.
+    //
+    // Each sample sent is lost with the loss probability, or delivered
+    // after the delay, plus or minus a uniform jitter (so that samples may
+    // overtake each other); with the reorder probability, a sample is held
+    // back for another delay (at least 1 ms). A single thread delivers the
+    // samples in flight, from a preallocated heap ordered by due time, with
+    // the time they were sent: the receivers see the delay in the age of
+    // the samples. The samples that do not fit in the heap are lost, and
+    // so are those whose delivery throws (e.g. a write timeout), which are
+    // counted as failed. Sending takes the lock of the link.
+    class Link {
+    public:
+        // Delivers a sample, with its send time on latency::system_now_ns()
+        typedef std::function<void(float position, int64_t sent_ns)> Deliver;
+
+        Link(const LinkProfile& profile, Deliver deliver, size_t capacity = DEFAULT_CAPACITY)
+            : profile_(profile),
+            deliver_(deliver),
+            capacity_(capacity),
+            random_(std::random_device()()),
+            sent_(0),
+            lost_(0),
+            reordered_(0),
+            overflowed_(0),
+            failed_(0),
+            stop_(false)
+        {
+            in_flight_.reserve(capacity_);
+            thread_ = std::thread(&Link::run, this);
+        }
+
+        ~Link()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            condition_.notify_one();
+            thread_.join();
+        }
+
+        // Sends a sample through the link; never blocks on the delivery
+        void send(float position)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sent_++;
+            if (uniform_(random_) < profile_.loss) {
+                lost_++;
+                return;
+            }
+            if (in_flight_.size() == capacity_) {
+                overflowed_++;
+                return;
+            }
+
+            int64_t delay_ns = static_cast<int64_t>(profile_.delay_us) * 1000;
+            if (profile_.jitter_us > 0) {
+                int64_t jitter_ns = static_cast<int64_t>(profile_.jitter_us) * 1000;
+                delay_ns += static_cast<int64_t>((2.0 * uniform_(random_) - 1.0) * jitter_ns);
+            }
+            if (uniform_(random_) < profile_.reorder) {
+                delay_ns += std::max<int64_t>(profile_.delay_us * 1000LL, 1000000);
+                reordered_++;
+            }
+            InFlight sample;
+            sample.due_ns = latency::now_ns() + std::max<int64_t>(delay_ns, 0);
+            sample.sent_ns = latency::system_now_ns();
+            sample.position = position;
+            bool earliest = in_flight_.empty() || sample.due_ns < in_flight_.front().due_ns;
+            in_flight_.push_back(sample);
+            std::push_heap(in_flight_.begin(), in_flight_.end(), later);
+            if (earliest) {
+                condition_.notify_one();
+            }
+        }
+
+        // Prints what the link did to the samples sent through it
+        void print_statistics(std::ostream& out) const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            out << "Simulated link: " << sent_ << " samples sent, "
+                << lost_ << " lost, " << reordered_ << " reordered, "
+                << overflowed_ << " overflowed, " << failed_ << " failed (loss "
+                << profile_.loss * 100.0 << "%, delay " << profile_.delay_us << " +/- " << profile_.jitter_us
+                << " us, reorder " << profile_.reorder * 100.0 << "%)" << std::endl;
+        }
+
+    private:
+        struct InFlight {
+            int64_t due_ns;   // on latency::now_ns()
+            int64_t sent_ns;  // on latency::system_now_ns()
+            float position;
+        };
+
+        // Orders the heap by due time, the earliest first
+        static bool later(const InFlight& a, const InFlight& b) { return a.due_ns > b.due_ns; }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stop_) {
+                if (in_flight_.empty()) {
+                    condition_.wait(lock);
+                    continue;
+                }
+                int64_t due_ns = in_flight_.front().due_ns;
+                if (due_ns > latency::now_ns()) {
+                    condition_.wait_until(lock, due_ns);
+                    continue;
+                }
+                std::pop_heap(in_flight_.begin(), in_flight_.end(), later);
+                InFlight sample = in_flight_.back();
+                in_flight_.pop_back();
+                lock.unlock();
+                try {
+                    deliver_(sample.position, sample.sent_ns);
+                    lock.lock();
+                } catch (const std::exception& ex) {
+                    lock.lock();
+                    if (failed_++ == 0) {
+                        std::cerr << "Simulated link: delivery failed: " << ex.what() << std::endl;
+                    }
+                }
+            }
+            // The samples still in flight are lost with the link
+        }
+
+        LinkProfile profile_;
+        Deliver deliver_;
+        size_t capacity_;
+        std::vector<InFlight> in_flight_;  // heap, reserved to capacity_
+        std::mt19937 random_;
+        std::uniform_real_distribution<double> uniform_;  // [0, 1)
+        uint64_t sent_;
+        uint64_t lost_;
+        uint64_t reordered_;
+        uint64_t overflowed_;
+        uint64_t failed_;
+        bool stop_;
+        mutable std::mutex mutex_;
+        periodic::MonotonicCondition condition_;
+        std::thread thread_;
+    };
+
+    // Kills the process (SIGKILL, without a chance to clean up, as a crash
+    // would) once it has run for a given time. A zero time disables it.
+    class CrashSchedule {
+    public:
+        explicit CrashSchedule(unsigned int after_ms)
+            : crash_ns_(after_ms > 0 ? latency::now_ns() + after_ms * 1000000LL : 0) {}
+
+        // Call periodically, e.g. from the write loop
+        void check() const
+        {
+            if (crash_ns_ > 0 && latency::now_ns() >= crash_ns_) {
+                std::cout << "Simulated crash" << std::endl;
+                kill(getpid(), SIGKILL);
+            }
+        }
+
+    private:
+        int64_t crash_ns_;
+    };
+
+}  // namespace netsim
+
+#endif  // NETSIM_HPP
@@ -0,0 +1,225 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef PERIODIC_HPP
+#define PERIODIC_HPP
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#ifdef RTI_LINUX
+#include <time.h>   // for clock_nanosleep()
+#include <pthread.h>  // for the monotonic condition variable
+#include <cerrno>   // for EINTR
+#include <cstring>  // for strerror()
+#endif
+
+#include "latency.hpp"  // for the jitter histogram
+
+namespace periodic {
+
+    // Sleeps until an absolute time of latency::now_ns()
+    inline void sleep_until(int64_t deadline_ns)
+    {
+#ifdef RTI_LINUX
+        // Absolute sleep on the same clock as std::chrono::steady_clock
+        struct timespec deadline;
+        deadline.tv_sec = deadline_ns / 1000000000LL;
+        deadline.tv_nsec = deadline_ns % 1000000000LL;
+        int result;
+        while ((result = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL)) == EINTR) {
+            // interrupted by a signal: sleep the rest of the time
+        }
+        if (result != 0) {
+            std::cerr << "clock_nanosleep() failed: " << strerror(result) << std::endl;
+        }
+#else
+        std::this_thread::sleep_until(
+            std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(deadline_ns)));
+#endif
+    }
+
+    const int64_t SLEEP_SLICE_NS = 100000000;  // 100 ms
+
+    // Sleeps until an absolute time of latency::now_ns(), in slices of at
+    // most SLEEP_SLICE_NS, so that a long sleep ends soon after 'stop' is
+    // set (e.g. application::shutdown_requested). Returns false if stopped.
+    inline bool sleep_until(int64_t deadline_ns, const std::atomic<bool>& stop)
+    {
+        while (!stop) {
+            int64_t slice_end_ns = latency::now_ns() + SLEEP_SLICE_NS;
+            if (deadline_ns <= slice_end_ns) {
+                sleep_until(deadline_ns);
+                return !stop;
+            }
+            sleep_until(slice_end_ns);
+        }
+        return false;
+    }
+
+    // A condition variable whose timed waits are on the monotonic clock of
+    // latency::now_ns(). Before GCC 10, libstdc++ turns a wait_until() on
+    // std::chrono::steady_clock into an absolute wait on CLOCK_REALTIME,
+    // which a step of the system clock (e.g. by NTP or PTP) lengthens or
+    // shortens; this one waits on a pthread condition variable set to
+    // CLOCK_MONOTONIC. Use with a std::unique_lock<std::mutex>.
+    class MonotonicCondition {
+    public:
+        MonotonicCondition()
+        {
+#ifdef RTI_LINUX
+            pthread_condattr_t attributes;
+            pthread_condattr_init(&attributes);
+            pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+            pthread_cond_init(&condition_, &attributes);
+            pthread_condattr_destroy(&attributes);
+#endif
+        }
+
+        ~MonotonicCondition()
+        {
+#ifdef RTI_LINUX
+            pthread_cond_destroy(&condition_);
+#endif
+        }
+
+        void notify_one()
+        {
+#ifdef RTI_LINUX
+            pthread_cond_signal(&condition_);
+#else
+            condition_.notify_one();
+#endif
+        }
+
+        void wait(std::unique_lock<std::mutex>& lock)
+        {
+#ifdef RTI_LINUX
+            pthread_cond_wait(&condition_, lock.mutex()->native_handle());
+#else
+            condition_.wait(lock);
+#endif
+        }
+
+        // Waits until notified or until an absolute time of
+        // latency::now_ns(), whichever comes first (or spuriously)
+        void wait_until(std::unique_lock<std::mutex>& lock, int64_t deadline_ns)
+        {
+#ifdef RTI_LINUX
+            struct timespec deadline;
+            deadline.tv_sec = deadline_ns / 1000000000LL;
+            deadline.tv_nsec = deadline_ns % 1000000000LL;
+            pthread_cond_timedwait(&condition_, lock.mutex()->native_handle(), &deadline);
+#else
+            condition_.wait_until(
+                lock,
+                std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline_ns)));
+#endif
+        }
+
+        template <typename Predicate>
+        void wait(std::unique_lock<std::mutex>& lock, Predicate predicate)
+        {
+            while (!predicate()) {
+                wait(lock);
+            }
+        }
+
+        // Returns the predicate, as std::condition_variable::wait_until()
+        template <typename Predicate>
+        bool wait_until(std::unique_lock<std::mutex>& lock, int64_t deadline_ns, Predicate predicate)
+        {
+            while (!predicate()) {
+                if (latency::now_ns() >= deadline_ns) {
+                    return predicate();
+                }
+                wait_until(lock, deadline_ns);
+            }
+            return true;
+        }
+
+    private:
+        MonotonicCondition(const MonotonicCondition&);
+        MonotonicCondition& operator=(const MonotonicCondition&);
+
+#ifdef RTI_LINUX
+        pthread_cond_t condition_;
+#else
+        std::condition_variable condition_;
+#endif
+    };
+
+    // Runs a loop at a fixed rate by sleeping until absolute deadlines.
+    //
+    // Every deadline is computed from the start time and the period, so
+    // the time spent working in a cycle (and the sleep error) never adds up
+    // as drift. The wake-up jitter of every cycle (how late the thread woke
+    // after its deadline) is recorded. A cycle that runs past the next
+    // deadline is counted as an overrun, and the missed deadlines are
+    // skipped rather than run back-to-back to catch up.
+    class Executor {
+    public:
+        explicit Executor(unsigned int rate_hz)
+            : period_ns_(1000000000LL / (rate_hz > 0 ? rate_hz : 1)),
+            next_deadline_ns_(latency::now_ns() + period_ns_),
+            overruns_(0),
+            cycles_(0) {}
+
+        // Blocks until the next deadline. Returns the wake-up time.
+        int64_t wait_next()
+        {
+            int64_t now = latency::now_ns();
+            if (now > next_deadline_ns_) {
+                // The previous cycle overran this deadline: re-phase to the
+                // next one in the future
+                int64_t missed = (now - next_deadline_ns_) / period_ns_ + 1;
+                overruns_ += missed;
+                next_deadline_ns_ += missed * period_ns_;
+            }
+
+            sleep_until(next_deadline_ns_);
+
+            int64_t wake_ns = latency::now_ns();
+            jitter_.record(wake_ns - next_deadline_ns_);
+            next_deadline_ns_ += period_ns_;
+            cycles_++;
+            return wake_ns;
+        }
+
+        int64_t period_ns() const { return period_ns_; }
+        uint64_t cycles() const { return cycles_; }
+        uint64_t overruns() const { return overruns_; }
+        const latency::Histogram& jitter() const { return jitter_; }
+
+        void print_statistics(std::ostream& out) const
+        {
+            out << "Cycles: " << cycles_ << " at " << 1e9 / period_ns_
+                << " Hz, overruns: " << overruns_ << std::endl;
+            jitter_.print(out, "Wake-up jitter (us):", 1000.0);
+        }
+
+    private:
+        int64_t period_ns_;
+        int64_t next_deadline_ns_;
+        uint64_t overruns_;
+        uint64_t cycles_;
+        latency::Histogram jitter_;
+    };
+
+}  // namespace periodic
+
+#endif  // PERIODIC_HPP
@@ -0,0 +1,66 @@
+#!/bin/bash
+######################################################################
+# publication_benchmark.sh
+# (C) Copyright 2020-2025 Real-Time Innovations, Inc.  All rights reserved.
+#
+# The use of this software is governed by the terms specified in the RTI
+# Labs License Agreement, available at https://www.rti.com/terms/RTILabs.
+#
+# By accessing, downloading, or otherwise using this software, you agree to
+# be bound by those terms.
+######################################################################
+#
+# Compares the publication modes of the SteeringController at a high
+# command rate: synchronous (as configured), batched, asynchronous, and
+# asynchronous with batches sent by a flow controller.
+#
+# For each mode, the controller streams stamped commands to an echoing
+# actuator at RATE Hz for DURATION seconds, then reports the CPU time per
+# sample, the UDP datagrams per second and per sample, and the round-trip
+# latency.
+#
+# Usage:
+#     ./publication_benchmark.sh <arch>
+# e.g.
+#     RATE=10000 BATCH=50 WINDOW=2000 ./publication_benchmark.sh x64Linux4gcc7.3.0
+
+ARCH=$1
+RATE=${RATE:-1000}
+DURATION=${DURATION:-10}
+BATCH=${BATCH:-10}
+WINDOW=${WINDOW:-1000}
+RESULTS=${RESULTS:-publication_results}
+DATABUSHOME=${DATABUSHOME:-bus}
+
+if [ -z "$ARCH" ]; then
+    echo "Usage: $0 <arch>"
+    exit 1
+fi
+
+RUN="$DATABUSHOME/bin/run Steering"
+APPS=./objs/$ARCH
+mkdir -p $RESULTS
+
+MODES=(sync batch async async-batch)
+OPTIONS=(
+    ""
+    "--batch $BATCH --batch-window $WINDOW"
+    "--async"
+    "--async --batch $BATCH --batch-window $WINDOW --flow-period $WINDOW"
+)
+
+for i in ${!MODES[@]}; do
+    mode=${MODES[$i]}
+    log=$RESULTS/$mode.txt
+    echo "$mode, $RATE Hz:"
+
+    # UDP, so that the datagrams are counted
+    $RUN $APPS/SteeringColumn --transport udpv4 > /dev/null &
+    column=$!
+    $RUN $APPS/SteeringController --transport udpv4 --rate $RATE \
+        --stream $DURATION ${OPTIONS[$i]} > $log
+
+    pkill -INT -f "SteeringColumn --transport udpv4"
+    wait $column
+    grep -e "^CPU time" -e "^UDP datagrams" -e "^Round-trip" $log
+done
@@ -0,0 +1,104 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef REALTIME_HPP
+#define REALTIME_HPP
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>   // for mlockall()
+#ifdef __GLIBC__
+#include <malloc.h>     // for mallopt()
+#endif
+
+namespace realtime {
+
+    const size_t STACK_PREFAULT_BYTES = 256 * 1024;
+    const size_t HEAP_PREFAULT_BYTES = 16 * 1024 * 1024;
+    const size_t PAGE_BYTES = 4096;
+
+    // Locks all current and future pages of the process in memory and
+    // pre-faults a heap reserve, so that the control loop does not take page
+    // faults later. Call before the participant is enabled, so that the
+    // middleware's own allocations are locked as well.
+    inline void lock_memory()
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            std::cerr << "Could not lock memory: " << strerror(errno) << std::endl;
+            return;
+        }
+
+#ifdef __GLIBC__
+        // Keep freed memory in the process instead of returning it to the
+        // system (and faulting it back in on the next allocation)
+        mallopt(M_TRIM_THRESHOLD, -1);
+        mallopt(M_MMAP_MAX, 0);
+#endif
+        char *heap = static_cast<char *>(malloc(HEAP_PREFAULT_BYTES));
+        if (heap != NULL) {
+            for (size_t i = 0; i < HEAP_PREFAULT_BYTES; i += PAGE_BYTES) {
+                heap[i] = 0;
+            }
+            free(heap);
+        }
+    }
+
+    // Touches the calling thread's stack, so that it is resident (and, with
+    // lock_memory(), locked) before the control loop runs
+    inline void prefault_stack()
+    {
+        volatile char stack[STACK_PREFAULT_BYTES];
+        for (size_t i = 0; i < STACK_PREFAULT_BYTES; i += PAGE_BYTES) {
+            stack[i] = 0;
+        }
+        (void) stack[0];
+    }
+
+    // Gives the calling thread a SCHED_FIFO priority (if priority > 0) and
+    // pins it to a CPU (if cpu >= 0). Failures, e.g. for lack of privileges,
+    // are reported and the thread keeps running with normal scheduling.
+    inline void configure_thread(int priority, int cpu)
+    {
+        if (priority > 0) {
+            struct sched_param param;
+            memset(&param, 0, sizeof(param));
+            param.sched_priority = priority;
+            int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+            if (result != 0) {
+                std::cerr << "Could not set SCHED_FIFO priority " << priority
+                          << ": " << strerror(result) << std::endl;
+            }
+        }
+
+        if (cpu >= 0) {
+#ifdef RTI_LINUX
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            CPU_SET(cpu, &cpu_set);
+            int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+            if (result != 0) {
+                std::cerr << "Could not pin thread to CPU " << cpu
+                          << ": " << strerror(result) << std::endl;
+            }
+#else
+            std::cerr << "CPU affinity is not supported on this platform" << std::endl;
+#endif
+        }
+    }
+
+}  // namespace realtime
+
+#endif  // REALTIME_HPP
@@ -0,0 +1,166 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+namespace ring_buffer {
+
+    // Bounded lock-free queue for exactly one producer thread and one
+    // consumer thread.
+    //
+    // The storage is allocated once, up front; push() and pop() never block
+    // and never allocate. The capacity is rounded up to a power of two.
+    template <typename T>
+    class SpscRing {
+    public:
+        explicit SpscRing(size_t capacity)
+            : slots_(round_up(capacity)),
+            mask_(slots_.size() - 1),
+            head_(0),
+            tail_(0) {}
+
+        // Producer only. Returns false (and drops the value) if full.
+        bool push(const T& value)
+        {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+                return false;
+            }
+            slots_[tail & mask_] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only. Returns false if empty.
+        bool pop(T& value)
+        {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            value = slots_[head & mask_];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_t capacity() const { return slots_.size(); }
+
+    private:
+        static size_t round_up(size_t capacity)
+        {
+            size_t size = 1;
+            while (size < capacity) {
+                size <<= 1;
+            }
+            return size;
+        }
+
+        std::vector<T> slots_;
+        size_t mask_;
+        // Keep the indices on separate cache lines, so the producer and the
+        // consumer do not invalidate each other's line on every operation
+        alignas(64) std::atomic<size_t> head_;
+        alignas(64) std::atomic<size_t> tail_;
+    };
+
+    // Bounded lock-free queue for any number of producer threads and one
+    // consumer thread.
+    //
+    // Each slot carries a sequence number that tells whose turn it is:
+    // producers claim a slot with a compare-and-swap on the tail, write it,
+    // then publish it by advancing its sequence; the consumer takes the
+    // slot at the head once it is published. A producer that finds the
+    // queue full drops the value, so push() never blocks, and neither
+    // push() nor pop() allocates. The capacity is rounded up to a power of
+    // two.
+    template <typename T>
+    class MpscRing {
+    public:
+        explicit MpscRing(size_t capacity)
+            : slots_(round_up(capacity)),
+            mask_(slots_.size() - 1),
+            head_(0),
+            tail_(0)
+        {
+            for (size_t i = 0; i < slots_.size(); i++) {
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        // Any thread. Returns false (and drops the value) if full.
+        bool push(const T& value)
+        {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots_[tail & mask_];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                if (sequence == tail) {
+                    // Free: claim it, unless another producer was faster
+                    if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                        slot.value = value;
+                        slot.sequence.store(tail + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (sequence < tail) {
+                    return false;  // not yet consumed: full
+                } else {
+                    tail = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Consumer only. Returns false if empty (or if the next value is
+        // still being written).
+        bool pop(T& value)
+        {
+            size_t head = head_.load(std::memory_order_relaxed);
+            Slot& slot = slots_[head & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+                return false;
+            }
+            value = slot.value;
+            slot.sequence.store(head + slots_.size(), std::memory_order_release);
+            head_.store(head + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        size_t capacity() const { return slots_.size(); }
+
+    private:
+        struct Slot {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        static size_t round_up(size_t capacity)
+        {
+            size_t size = 1;
+            while (size < capacity) {
+                size <<= 1;
+            }
+            return size;
+        }
+
+        std::vector<Slot> slots_;
+        size_t mask_;
+        alignas(64) std::atomic<size_t> head_;
+        alignas(64) std::atomic<size_t> tail_;
+    };
+
+}  // namespace ring_buffer
+
+#endif  // RING_BUFFER_HPP
@@ -0,0 +1,99 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef STARTUP_HPP
+#define STARTUP_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstring>
+
+#include "latency.hpp"  // for now_ns()
+
+namespace startup {
+
+    // Times the phases of an app's startup, from main() to its first
+    // useful work (e.g. the first actuation). Each phase is recorded the
+    // first time it is reached, from any thread; once finished, marking a
+    // phase costs a single atomic load.
+    class Profiler {
+    public:
+        explicit Profiler(const char *name)
+            : name_(name), start_ns_(latency::now_ns()), finished_(false) {}
+
+        // Records the end of a phase, unless it was already reached
+        void mark(const char *phase)
+        {
+            if (finished_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            int64_t now_ns = latency::now_ns();
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < phases_.size(); i++) {
+                if (strcmp(phases_[i].name, phase) == 0) {
+                    return;
+                }
+            }
+            Phase reached = { phase, now_ns };
+            phases_.push_back(reached);
+        }
+
+        bool finished() const { return finished_.load(std::memory_order_relaxed); }
+
+        // Records the last phase and prints the profile, once
+        void finish(const char *phase, std::ostream& out)
+        {
+            if (finished()) {
+                return;
+            }
+            mark(phase);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (finished_.exchange(true)) {
+                return;
+            }
+
+            std::ios::fmtflags flags(out.flags());
+            std::streamsize precision(out.precision());
+            out << "Startup profile of " << name_ << " in milliseconds (phase, total):"
+                << std::endl;
+            int64_t previous_ns = start_ns_;
+            for (size_t i = 0; i < phases_.size(); i++) {
+                out << "  " << std::left << std::setw(32) << std::setfill(' ')
+                    << phases_[i].name << std::right << std::fixed << std::setprecision(1)
+                    << std::setw(9) << (phases_[i].reached_ns - previous_ns) / 1e6
+                    << std::setw(9) << (phases_[i].reached_ns - start_ns_) / 1e6
+                    << std::endl;
+                previous_ns = phases_[i].reached_ns;
+            }
+            out.flags(flags);
+            out.precision(precision);
+        }
+
+    private:
+        struct Phase {
+            const char *name;
+            int64_t reached_ns;
+        };
+
+        const char *name_;
+        int64_t start_ns_;
+        std::atomic<bool> finished_;
+        std::mutex mutex_;
+        std::vector<Phase> phases_;
+    };
+
+}  // namespace startup
+
+#endif  // STARTUP_HPP
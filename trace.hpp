@@ -0,0 +1,178 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace trace {
+
+    // What a trace record describes
+    enum RecordKind {
+        command_sent = 1,       // SteeringDesired written by a controller
+        command_received = 2,   // SteeringDesired taken by the actuator
+        status_written = 3      // SteeringActual written by the actuator
+    };
+
+    // A trace file is a FileHeader followed by fixed-size Records
+    struct FileHeader {
+        char magic[4];          // "STRC"
+        uint32_t version;
+        uint64_t record_count;  // 0 if the recorder did not close the file
+    };
+
+    struct Record {
+        int64_t timestamp_ns;   // system clock
+        uint32_t kind;          // RecordKind
+        float position;
+    };
+
+    const uint32_t VERSION = 1;
+    const size_t DEFAULT_CAPACITY = 1 << 20;  // records (16 MB)
+
+    // Appends records to a memory-mapped trace file.
+    //
+    // The file is sized for 'capacity' records and mapped up front, so that
+    // recording is one atomic increment and a 16 byte store, from any
+    // number of threads, with no system call. Records that do not fit are
+    // counted and dropped. Closing the file trims it to the records written.
+    class Recorder {
+    public:
+        Recorder() : fd_(-1), mapping_(NULL), capacity_(0), next_(0), dropped_(0) {}
+
+        ~Recorder() { close(); }
+
+        // Returns false (and records nothing) if the file cannot be created
+        bool open(const std::string& path, size_t capacity = DEFAULT_CAPACITY)
+        {
+            size_t bytes = sizeof(FileHeader) + capacity * sizeof(Record);
+            fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd_ < 0 || ftruncate(fd_, bytes) != 0) {
+                std::cerr << "Could not create trace " << path << ": "
+                          << strerror(errno) << std::endl;
+                close();
+                return false;
+            }
+
+            int flags = MAP_SHARED;
+#ifdef RTI_LINUX
+            flags |= MAP_POPULATE;  // no page faults while recording
+#endif
+            void *mapping = mmap(NULL, bytes, PROT_READ | PROT_WRITE, flags, fd_, 0);
+            if (mapping == MAP_FAILED) {
+                std::cerr << "Could not map trace " << path << ": "
+                          << strerror(errno) << std::endl;
+                close();
+                return false;
+            }
+
+            mapping_ = static_cast<char *>(mapping);
+            capacity_ = capacity;
+            FileHeader *header = reinterpret_cast<FileHeader *>(mapping_);
+            memcpy(header->magic, "STRC", 4);
+            header->version = VERSION;
+            header->record_count = 0;
+            return true;
+        }
+
+        bool is_open() const { return mapping_ != NULL; }
+
+        void record(RecordKind kind, float position, int64_t timestamp_ns)
+        {
+            if (mapping_ == NULL) {
+                return;
+            }
+            size_t index = next_.fetch_add(1, std::memory_order_relaxed);
+            if (index >= capacity_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            Record *slot = records() + index;
+            slot->kind = kind;
+            slot->position = position;
+            slot->timestamp_ns = timestamp_ns;
+        }
+
+        uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+        void close()
+        {
+            if (mapping_ != NULL) {
+                size_t count = std::min(next_.load(), capacity_);
+                reinterpret_cast<FileHeader *>(mapping_)->record_count = count;
+                munmap(mapping_, sizeof(FileHeader) + capacity_ * sizeof(Record));
+                mapping_ = NULL;
+                if (ftruncate(fd_, sizeof(FileHeader) + count * sizeof(Record)) != 0) {
+                    std::cerr << "Could not trim trace: " << strerror(errno) << std::endl;
+                }
+            }
+            if (fd_ >= 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+
+    private:
+        Record *records()
+        {
+            return reinterpret_cast<Record *>(mapping_ + sizeof(FileHeader));
+        }
+
+        int fd_;
+        char *mapping_;
+        size_t capacity_;
+        std::atomic<size_t> next_;
+        std::atomic<uint64_t> dropped_;
+    };
+
+    // Loads the records of a trace file. A file that was not closed (e.g.
+    // the recording app crashed) is read up to its last complete record.
+    inline bool load(const std::string& path, std::vector<Record>& records)
+    {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        FileHeader header;
+        if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))
+                || memcmp(header.magic, "STRC", 4) != 0
+                || header.version != VERSION) {
+            std::cerr << "Not a steering trace: " << path << std::endl;
+            return false;
+        }
+
+        Record record;
+        records.clear();
+        while (in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+            if (header.record_count == 0 && record.timestamp_ns == 0) {
+                break;  // end of the records of an unclosed file
+            }
+            records.push_back(record);
+            if (header.record_count != 0 && records.size() == header.record_count) {
+                break;
+            }
+        }
+        return true;
+    }
+
+}  // namespace trace
+
+#endif  // TRACE_HPP
@@ -0,0 +1,263 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef TRANSPORT_HPP
+#define TRANSPORT_HPP
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <memory>
+
+#include <dds/domain/ddsdomain.hpp>
+#include <dds/pub/ddspub.hpp>
+
+#include "application.hpp"  // for application::Transport
+#include "netsim.hpp"       // for the simulated link
+
+namespace transport {
+
+    // Overrides the builtin transports of a participant created from the
+    // SteeringParticipantLib configuration. Must be called before the
+    // participant is enabled.
+    inline void configure(
+        dds::domain::DomainParticipant& participant,
+        application::Transport transport)
+    {
+        if (transport == application::Transport::configured) {
+            return;
+        }
+
+        auto participant_qos = participant.qos();
+        if (transport == application::Transport::shmem) {
+            // Co-located apps only: discover and exchange data over shared
+            // memory, bypassing the network stack
+            participant_qos << rti::core::policy::TransportBuiltin(
+                rti::core::policy::TransportBuiltinMask::shmem());
+            // Keep the rest of the configured discovery settings
+            rti::core::policy::Discovery discovery =
+                    participant_qos.policy<rti::core::policy::Discovery>();
+            discovery.initial_peers(dds::core::StringSeq(1, "builtin.shmem://"));
+            participant_qos << discovery;
+        } else {
+            participant_qos << rti::core::policy::TransportBuiltin(
+                rti::core::policy::TransportBuiltinMask::udpv4());
+        }
+        participant.qos(participant_qos);
+    }
+
+    // Shortens discovery for a known deployment. 'peers' (comma-separated,
+    // e.g. "shmem://,192.168.1.10") replaces the configured initial peers,
+    // so that no time or traffic is spent announcing to other locators;
+    // 'fast' sends more initial participant announcements, closer together,
+    // so that a restarted app is discovered within milliseconds rather than
+    // at the next periodic announcement. Must be called before the
+    // participant is enabled.
+    inline void configure_discovery(
+        dds::domain::DomainParticipant& participant,
+        const std::string& peers,
+        bool fast)
+    {
+        if (peers.empty() && !fast) {
+            return;
+        }
+
+        auto participant_qos = participant.qos();
+        if (!peers.empty()) {
+            dds::core::StringSeq initial_peers;
+            size_t begin = 0;
+            while (begin <= peers.size()) {
+                size_t end = peers.find(',', begin);
+                if (end == std::string::npos) {
+                    end = peers.size();
+                }
+                if (end > begin) {
+                    initial_peers.push_back(peers.substr(begin, end - begin));
+                }
+                begin = end + 1;
+            }
+            rti::core::policy::Discovery discovery =
+                    participant_qos.policy<rti::core::policy::Discovery>();
+            discovery.initial_peers(initial_peers);
+            participant_qos << discovery;
+        }
+        if (fast) {
+            rti::core::policy::DiscoveryConfig discovery_config =
+                    participant_qos.policy<rti::core::policy::DiscoveryConfig>();
+            discovery_config.initial_participant_announcements(10);
+            discovery_config.min_initial_participant_announcement_period(
+                    dds::core::Duration::from_millisecs(10));
+            discovery_config.max_initial_participant_announcement_period(
+                    dds::core::Duration::from_millisecs(100));
+            participant_qos << discovery_config;
+        }
+        participant.qos(participant_qos);
+    }
+
+    // Name of the flow controller created for --flow-period
+    const char *const FLOW_CONTROLLER_NAME = "SteeringFlowController";
+
+    // Sets up the batching and asynchronous publication requested on the
+    // command line in the QoS of a DataWriter:
+    //  - batching groups the samples written into one packet, sent when it
+    //    holds batch_samples samples or batch_window_us after its first one;
+    //  - asynchronous publication hands the packets to a flow controller
+    //    thread, so that write() returns without sending. With a flow
+    //    period, the flow controller sends at most one packet per period.
+    // Returns the flow controller created, if any, which must be kept while
+    // the DataWriter exists. Must be called before the participant is
+    // enabled.
+    inline rti::pub::FlowController configure_publication(
+        dds::domain::DomainParticipant& participant,
+        dds::pub::qos::DataWriterQos& writer_qos,
+        const application::ApplicationArguments& arguments)
+    {
+        if (arguments.batch_samples > 0 || arguments.batch_window_us > 0) {
+            rti::core::policy::Batch batch;
+            batch.enable(true);
+            if (arguments.batch_samples > 0) {
+                batch.max_samples(arguments.batch_samples);
+            }
+            if (arguments.batch_window_us > 0) {
+                batch.max_flush_delay(
+                        dds::core::Duration::from_microsecs(arguments.batch_window_us));
+            } else {
+                std::cout << "No --batch-window: a partial batch waits for the next "
+                          << "samples" << std::endl;
+            }
+            writer_qos << batch;
+        }
+
+        if (!arguments.async_publish) {
+            return dds::core::null;
+        }
+        if (arguments.flow_period_us == 0) {
+            writer_qos << rti::core::policy::PublishMode::Asynchronous();
+            return dds::core::null;
+        }
+
+        // One token per period, one packet per token
+        rti::pub::FlowControllerProperty property(
+            rti::pub::FlowControllerSchedulingPolicy::EDF,
+            rti::pub::FlowControllerTokenBucketProperty(
+                1,  // max tokens
+                1,  // tokens added per period
+                0,  // tokens leaked per period
+                dds::core::Duration::from_microsecs(arguments.flow_period_us),
+                dds::core::LENGTH_UNLIMITED));  // bytes per token
+        rti::pub::FlowController flow_controller(
+            participant,
+            FLOW_CONTROLLER_NAME,
+            property);
+        writer_qos << rti::core::policy::PublishMode::Asynchronous(FLOW_CONTROLLER_NAME);
+        return flow_controller;
+    }
+
+    // UDP datagrams sent by the host so far (from /proc/net/snmp), or -1
+    // where unavailable. Counts the datagrams of every process, so compare
+    // publication modes on an otherwise idle host.
+    inline int64_t udp_datagrams_sent()
+    {
+        std::ifstream snmp("/proc/net/snmp");
+        std::string names;
+        std::string line;
+        while (std::getline(snmp, line)) {
+            if (line.compare(0, 4, "Udp:") != 0) {
+                continue;
+            }
+            if (names.empty()) {
+                names = line;
+                continue;
+            }
+
+            // The second "Udp:" line holds the values of the first one
+            std::istringstream name_stream(names);
+            std::istringstream value_stream(line);
+            std::string name;
+            std::string value;
+            while (name_stream >> name && value_stream >> value) {
+                if (name == "OutDatagrams") {
+                    return std::stoll(value);
+                }
+            }
+            break;
+        }
+        return -1;
+    }
+
+    // Writes steering samples without constructing a temporary per write:
+    // a single preallocated sample is reused for every write.
+    //
+    // With an enabled link profile (--link), the samples go through a
+    // simulated link (see netsim.hpp), whose thread writes them when they
+    // are due, stamped with the time they were sent.
+    template <typename T>
+    class SampleWriter {
+    public:
+        explicit SampleWriter(
+            dds::pub::DataWriter<T> writer,
+            const netsim::LinkProfile& link = netsim::LinkProfile())
+            : writer_(writer)
+        {
+            if (link.enabled()) {
+                link_.reset(new netsim::Link(link, [this](float position, int64_t sent_ns) {
+                    write_sample(position, sent_ns);
+                }));
+            }
+        }
+
+        void write(float position)
+        {
+            if (link_) {
+                link_->send(position);
+            } else {
+                write_sample(position, 0);
+            }
+        }
+
+        dds::pub::DataWriter<T>& writer() { return writer_; }
+
+        // Prints the statistics of the simulated link, if any
+        void print_statistics(std::ostream& out) const
+        {
+            if (link_) {
+                link_->print_statistics(out);
+            }
+        }
+
+    private:
+        // Writes now, stamped with 'source_ns' (latency::system_now_ns()),
+        // or with the current time if 0
+        void write_sample(float position, int64_t source_ns)
+        {
+            sample_.position(position);
+            if (source_ns == 0) {
+                writer_.write(sample_);
+            } else {
+                writer_.write(sample_, dds::core::Time(
+                    static_cast<int32_t>(source_ns / 1000000000),
+                    static_cast<uint32_t>(source_ns % 1000000000)));
+            }
+        }
+
+        SampleWriter(const SampleWriter&);
+        SampleWriter& operator=(const SampleWriter&);
+
+        dds::pub::DataWriter<T> writer_;
+        T sample_;
+        // Destroyed first, so that its thread no longer writes
+        std::unique_ptr<netsim::Link> link_;
+    };
+
+}  // namespace transport
+
+#endif  // TRANSPORT_HPP
@@ -0,0 +1,175 @@
+/*
+* (c) Copyright, Real-Time Innovations, 2020.  All rights reserved.
+* RTI grants Licensee a license to use, modify, compile, and create derivative
+* works of the software solely for use with RTI Connext DDS. Licensee may
+* redistribute copies of the software provided that all such copies are subject
+* to this license. The software is provided "as is", with no warranty of any
+* type, including any warranty for fitness for any purpose. RTI is under no
+* obligation to maintain or support the software. RTI shall not be liable for
+* any incidental or consequential damages arising out of the use or inability
+* to use the software.
+*/
+
+#ifndef WATCHDOG_HPP
+#define WATCHDOG_HPP
+
+#include <iostream>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "latency.hpp"   // for now_ns() and the lateness histogram
+#include "realtime.hpp"  // for the thread priority
+#include "periodic.hpp"  // for the monotonic condition variable
+
+namespace watchdog {
+
+    // Command timeouts on the monotonic clock, independent of the DDS
+    // statuses and of the dispatch of the WaitSets.
+    //
+    // Each channel (e.g. the column of a vehicle) is armed by every command
+    // it receives, and expires when no command arrives within the budget.
+    // A single thread waits for the earliest deadline of all the channels
+    // and calls the handler of an expired channel, which is then disarmed
+    // until its next command. Arming is an atomic exchange; the thread is
+    // only notified when a disarmed channel is armed.
+    class Watchdog {
+    public:
+        // Called with the deadline the channel missed, on latency::now_ns()
+        typedef std::function<void(size_t channel, int64_t deadline_ns)> Handler;
+
+        // A zero budget disables the watchdog
+        Watchdog(int64_t budget_ns, size_t channels)
+            : budget_ns_(budget_ns),
+            channel_count_(channels),
+            deadlines_ns_(new std::atomic<int64_t>[channels]),
+            trips_(0),
+            wakeup_(false),
+            stop_(false)
+        {
+            for (size_t i = 0; i < channel_count_; i++) {
+                deadlines_ns_[i] = 0;
+            }
+        }
+
+        ~Watchdog() { stop(); }
+
+        bool enabled() const { return budget_ns_ > 0; }
+
+        // Starts the watchdog thread, with the given SCHED_FIFO priority (if
+        // priority > 0); the handler is called on that thread
+        void start(Handler handler, int priority)
+        {
+            if (!enabled()) {
+                return;
+            }
+            handler_ = handler;
+            thread_ = std::thread([this, priority]() {
+                realtime::configure_thread(priority, -1);
+                run();
+            });
+        }
+
+        void stop()
+        {
+            if (thread_.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stop_ = true;
+                }
+                condition_.notify_one();
+                thread_.join();
+            }
+        }
+
+        // A command was received on the channel: restart its timeout
+        void arm(size_t channel)
+        {
+            if (!enabled()) {
+                return;
+            }
+            int64_t previous_ns = deadlines_ns_[channel].exchange(latency::now_ns() + budget_ns_);
+            if (previous_ns == 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                wakeup_ = true;
+                condition_.notify_one();
+            }
+        }
+
+        // Whether the channel is waiting for a command. An expired channel
+        // is disarmed before its handler is called, so a handler can tell
+        // whether a command arrived meanwhile.
+        bool armed(size_t channel) const { return deadlines_ns_[channel].load() != 0; }
+
+        uint64_t trips() const { return trips_.load(); }
+
+        // Prints how often and how late (after the deadline) the watchdog
+        // fired. Call after stop().
+        void print_statistics(std::ostream& out) const
+        {
+            if (!enabled()) {
+                return;
+            }
+            out << "Watchdog trips: " << trips() << " (budget "
+                << budget_ns_ / 1000 << " us)" << std::endl;
+            lateness_.print(out, "Watchdog lateness (us):", 1000.0);
+        }
+
+    private:
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stop_) {
+                // Channels armed from now on wake the thread
+                wakeup_ = false;
+                int64_t earliest_ns = 0;
+                for (size_t i = 0; i < channel_count_; i++) {
+                    int64_t deadline_ns = deadlines_ns_[i].load();
+                    if (deadline_ns == 0) {
+                        continue;
+                    }
+                    int64_t now_ns = latency::now_ns();
+                    if (deadline_ns > now_ns) {
+                        if (earliest_ns == 0 || deadline_ns < earliest_ns) {
+                            earliest_ns = deadline_ns;
+                        }
+                    } else if (deadlines_ns_[i].compare_exchange_strong(deadline_ns, 0)) {
+                        // Expired, and not re-armed meanwhile
+                        lateness_.record(now_ns - deadline_ns);
+                        trips_++;
+                        lock.unlock();
+                        handler_(i, deadline_ns);
+                        lock.lock();
+                    } else if (earliest_ns == 0 || deadline_ns < earliest_ns) {
+                        // Re-armed meanwhile: wait for its new deadline
+                        earliest_ns = deadline_ns;
+                    }
+                }
+
+                if (earliest_ns == 0) {
+                    condition_.wait(lock, [this]() { return wakeup_ || stop_; });
+                } else {
+                    condition_.wait_until(lock, earliest_ns, [this]() { return wakeup_ || stop_; });
+                }
+            }
+        }
+
+        int64_t budget_ns_;
+        size_t channel_count_;
+        // Deadline of each channel on latency::now_ns(), 0 when disarmed
+        std::unique_ptr<std::atomic<int64_t>[]> deadlines_ns_;
+        std::atomic<uint64_t> trips_;
+        latency::Histogram lateness_;
+        Handler handler_;
+        bool wakeup_;
+        bool stop_;
+        std::mutex mutex_;
+        periodic::MonotonicCondition condition_;
+        std::thread thread_;
+    };
+
+}  // namespace watchdog
+
+#endif  // WATCHDOG_HPP